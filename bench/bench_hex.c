@@ -0,0 +1,108 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include "binder_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef BINDER_HEX_NO_SIMD
+#  define BENCH_HEX_KERNEL "scalar"
+#else
+#  define BENCH_HEX_KERNEL "default"
+#endif
+
+/* How long each case runs, in microseconds */
+#define BENCH_HEX_TIME (500000)
+
+/* One SMS PDU and one log dump, see mtk_radio_ext_log_dump() */
+static const gsize bench_hex_sizes[] = { 160, 4096 };
+
+static
+void
+bench_hex_report(
+    const char* op,
+    gsize size,
+    guint64 runs,
+    gint64 usec)
+{
+    printf("%-7s %-6s %5u B: %8.1f MB/s\n", BENCH_HEX_KERNEL, op,
+        (guint)size, (double)size * runs / usec);
+}
+
+static
+void
+bench_hex_run(
+    gsize size)
+{
+    guint8* bin = g_malloc(size);
+    char* hex = g_malloc(2 * size + 1);
+    gint64 start, now;
+    guint64 runs;
+    gsize i;
+
+    for (i = 0; i < size; i++) {
+        bin[i] = (guint8)(i * 131 + 7);
+    }
+
+    runs = 0;
+    start = now = g_get_monotonic_time();
+    while (now - start < BENCH_HEX_TIME) {
+        for (i = 0; i < 1000; i++) {
+            binder_hex_encode(bin, size, hex, i & 1);
+        }
+        runs += i;
+        now = g_get_monotonic_time();
+    }
+    bench_hex_report("encode", size, runs, now - start);
+
+    runs = 0;
+    start = now = g_get_monotonic_time();
+    while (now - start < BENCH_HEX_TIME) {
+        for (i = 0; i < 1000; i++) {
+            if (!binder_hex_decode(hex, 2 * size, bin)) {
+                fprintf(stderr, "Decoding failed\n");
+                exit(1);
+            }
+        }
+        runs += i;
+        now = g_get_monotonic_time();
+    }
+    bench_hex_report("decode", size, runs, now - start);
+
+    g_free(hex);
+    g_free(bin);
+}
+
+int
+main(
+    int argc,
+    char* argv[])
+{
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS(bench_hex_sizes); i++) {
+        bench_hex_run(bench_hex_sizes[i]);
+    }
+    return 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,98 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include "binder_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* How long each case runs, in microseconds */
+#define BENCH_IMS_SMS_TIME (500000)
+
+/* SMS-SUBMIT with 140 octets of user data, after the SMSC address */
+#define BENCH_IMS_SMS_TPDU_LEN (7 + 140)
+
+/*
+ * Everything mtk_radio_ext_write_ims_sms() does before handing the
+ * buffers to the writer. The writer allocation is replaced with
+ * g_malloc0() because GBinderWriter needs a live binder connection.
+ */
+static
+void
+bench_ims_sms_run(
+    const char* name,
+    const guint8* pdu,
+    gsize pdu_len)
+{
+    const gsize smsc_len = pdu_len - BENCH_IMS_SMS_TPDU_LEN;
+    gint64 start, now;
+    guint64 runs = 0;
+    guint i;
+
+    start = now = g_get_monotonic_time();
+    while (now - start < BENCH_IMS_SMS_TIME) {
+        for (i = 0; i < 1000; i++) {
+            void* buf = g_malloc0(binder_ims_gsm_sms_size(pdu, pdu_len));
+            RadioImsSmsMessage* ims = binder_ims_gsm_sms_init(buf,
+                pdu, pdu_len);
+            const RadioGsmSmsMessage* gsm = ims->gsmMessage.data.ptr;
+
+            if (gsm->pdu.len != 2 * BENCH_IMS_SMS_TPDU_LEN ||
+                gsm->smscPdu.len != (smsc_len > 1 ? 2 * smsc_len : 0)) {
+                fprintf(stderr, "%s: unexpected layout\n", name);
+                exit(1);
+            }
+            g_free(buf);
+        }
+        runs += i;
+        now = g_get_monotonic_time();
+    }
+    printf("%-13s %3u B: %10.0f msg/s\n", name, (guint)pdu_len,
+        runs * 1e6 / (now - start));
+}
+
+int
+main(
+    int argc,
+    char* argv[])
+{
+    guint8 pdu[8 + BENCH_IMS_SMS_TPDU_LEN];
+    guint i;
+
+    /* International SMSC address, 7 octets after the length octet */
+    static const guint8 smsc[] = {
+        0x07, 0x91, 0x53, 0x48, 0x80, 0x00, 0x30, 0xf0
+    };
+
+    for (i = 0; i < sizeof(pdu); i++) {
+        pdu[i] = (guint8)(i * 131 + 7);
+    }
+    memcpy(pdu, smsc, sizeof(smsc));
+    bench_ims_sms_run("smsc", pdu, sizeof(pdu));
+
+    /* Default SMSC, zero length octet */
+    pdu[7] = 0;
+    bench_ims_sms_run("default smsc", pdu + 7, sizeof(pdu) - 7);
+    return 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
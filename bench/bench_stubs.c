@@ -0,0 +1,44 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+/*
+ * Outside of oFono these symbols don't get resolved against the daemon,
+ * benchmarks link this instead.
+ */
+
+#include <ofono/log.h>
+#include <ofono/radio-settings.h>
+
+void
+ofono_debug(
+    const char* format,
+    ...)
+{
+}
+
+enum ofono_radio_access_mode
+ofono_radio_access_max_mode(
+    enum ofono_radio_access_mode mask)
+{
+    return mask;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -10,6 +10,7 @@ Source: %{name}-%{version}.tar.bz2
 BuildRequires: ofono-devel
 BuildRequires: pkgconfig
 BuildRequires: pkgconfig(glib-2.0)
+BuildRequires: pkgconfig(gio-2.0)
 BuildRequires: pkgconfig(libglibutil)
 BuildRequires: pkgconfig(libgbinder-radio)
 BuildRequires: pkgconfig(libofonobinderpluginext)
@@ -37,4 +38,5 @@ install -m 644 mtk.conf %{buildroot}%{config_dir}
 %dir %{config_dir}
 %defattr(-,root,root,-)
 %config %{config_dir}/mtk.conf
+%config %{_sysconfdir}/dbus-1/system.d/org.ofono.mtk.conf
 %{plugin_dir}/mtkbinderpluginext.so
@@ -25,8 +25,21 @@
 #include <gbinder_writer.h>
 
 #include <gutil_idlepool.h>
+#include <gutil_macros.h>
 #include <gutil_misc.h>
 
+#include <string.h>
+
+/* BINDER_HEX_NO_SIMD forces the scalar kernels, e.g. for comparison */
+#if defined(BINDER_HEX_NO_SIMD)
+#elif defined(__SSE2__)
+#  include <emmintrin.h>
+#  define BINDER_HEX_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#  define BINDER_HEX_NEON
+#endif
+
 static GUtilIdlePool* binder_util_pool = NULL;
 static const char binder_empty_str[] = "";
 static const char PROTO_IP_STR[] = "IP";
@@ -42,6 +55,43 @@ static const char PROTO_IPV4V6_STR[] = "IPV4V6";
 #define RADIO_ACCESS_FAMILY_NR \
     (RAF_NR)
 
+/* Hex digit pairs, indexed by byte value */
+#define BINDER_HEX_ROW(h,a,b,c,d,e,f) \
+    {h,'0'}, {h,'1'}, {h,'2'}, {h,'3'}, {h,'4'}, {h,'5'}, {h,'6'}, {h,'7'}, \
+    {h,'8'}, {h,'9'}, {h,a}, {h,b}, {h,c}, {h,d}, {h,e}, {h,f}
+#define BINDER_HEX_UPPER(h) BINDER_HEX_ROW(h,'A','B','C','D','E','F')
+#define BINDER_HEX_LOWER(h) BINDER_HEX_ROW(h,'a','b','c','d','e','f')
+
+static const char binder_hex_upper[256][2] = {
+    BINDER_HEX_UPPER('0'), BINDER_HEX_UPPER('1'), BINDER_HEX_UPPER('2'),
+    BINDER_HEX_UPPER('3'), BINDER_HEX_UPPER('4'), BINDER_HEX_UPPER('5'),
+    BINDER_HEX_UPPER('6'), BINDER_HEX_UPPER('7'), BINDER_HEX_UPPER('8'),
+    BINDER_HEX_UPPER('9'), BINDER_HEX_UPPER('A'), BINDER_HEX_UPPER('B'),
+    BINDER_HEX_UPPER('C'), BINDER_HEX_UPPER('D'), BINDER_HEX_UPPER('E'),
+    BINDER_HEX_UPPER('F')
+};
+
+static const char binder_hex_lower[256][2] = {
+    BINDER_HEX_LOWER('0'), BINDER_HEX_LOWER('1'), BINDER_HEX_LOWER('2'),
+    BINDER_HEX_LOWER('3'), BINDER_HEX_LOWER('4'), BINDER_HEX_LOWER('5'),
+    BINDER_HEX_LOWER('6'), BINDER_HEX_LOWER('7'), BINDER_HEX_LOWER('8'),
+    BINDER_HEX_LOWER('9'), BINDER_HEX_LOWER('a'), BINDER_HEX_LOWER('b'),
+    BINDER_HEX_LOWER('c'), BINDER_HEX_LOWER('d'), BINDER_HEX_LOWER('e'),
+    BINDER_HEX_LOWER('f')
+};
+
+#undef BINDER_HEX_LOWER
+#undef BINDER_HEX_UPPER
+#undef BINDER_HEX_ROW
+
+/* Digit value plus one, zero for anything which isn't a hex digit */
+static const guint8 binder_hex_values[256] = {
+    ['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5,
+    ['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+    ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+    ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16
+};
+
 static
 const char*
 binder_pool_string(
@@ -647,15 +697,345 @@ binder_parse_mcc_mnc(
     return FALSE;
 }
 
+static
+void
+binder_hex_encode_scalar(
+    const guint8* in,
+    gsize size,
+    char* out,
+    gboolean lower)
+{
+    const char (*pairs)[2] = lower ? binder_hex_lower : binder_hex_upper;
+    gsize i;
+
+    for (i = 0; i < size; i++) {
+        memcpy(out + 2 * i, pairs[in[i]], 2);
+    }
+}
+
+static
+gboolean
+binder_hex_decode_scalar(
+    const char* hex,
+    gsize len,
+    guint8* out)
+{
+    gsize i;
+
+    for (i = 0; i < len; i += 2) {
+        const guint8 hi = binder_hex_values[(guint8)hex[i]];
+        const guint8 lo = binder_hex_values[(guint8)hex[i + 1]];
+
+        if (!hi || !lo) {
+            return FALSE;
+        }
+        *out++ = (guint8)(((hi - 1) << 4) | (lo - 1));
+    }
+    return TRUE;
+}
+
+#ifdef BINDER_HEX_SSE2
+
+static
+void
+binder_hex_encode_sse2(
+    const guint8* in,
+    gsize size,
+    char* out,
+    gboolean lower)
+{
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i zero = _mm_set1_epi8('0');
+    const __m128i alpha = _mm_set1_epi8((lower ? 'a' : 'A') - '0' - 10);
+    gsize i;
+
+    for (i = 0; i + 16 <= size; i += 16) {
+        const __m128i b = _mm_loadu_si128((const __m128i*)(in + i));
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(b, 4), mask);
+        const __m128i lo = _mm_and_si128(b, mask);
+        const __m128i h = _mm_add_epi8(_mm_add_epi8(hi, zero),
+            _mm_and_si128(_mm_cmpgt_epi8(hi, nine), alpha));
+        const __m128i l = _mm_add_epi8(_mm_add_epi8(lo, zero),
+            _mm_and_si128(_mm_cmpgt_epi8(lo, nine), alpha));
+
+        _mm_storeu_si128((__m128i*)(out + 2 * i), _mm_unpacklo_epi8(h, l));
+        _mm_storeu_si128((__m128i*)(out + 2 * i + 16),
+            _mm_unpackhi_epi8(h, l));
+    }
+    binder_hex_encode_scalar(in + i, size - i, out + 2 * i, lower);
+}
+
+static inline
+__m128i
+binder_hex_nibbles_sse2(
+    __m128i c,
+    __m128i* bad)
+{
+    const __m128i d = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    const __m128i a = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)),
+        _mm_set1_epi8('a'));
+    /* Unsigned x <= n is min(x, n) == x */
+    const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(d,
+        _mm_set1_epi8(9)), d);
+    const __m128i is_alpha = _mm_cmpeq_epi8(_mm_min_epu8(a,
+        _mm_set1_epi8(5)), a);
+
+    *bad = _mm_or_si128(*bad, _mm_andnot_si128(_mm_or_si128(is_digit,
+        is_alpha), _mm_set1_epi8(-1)));
+    return _mm_or_si128(_mm_and_si128(is_digit, d), _mm_and_si128(is_alpha,
+        _mm_add_epi8(a, _mm_set1_epi8(10))));
+}
+
+static inline
+__m128i
+binder_hex_pairs_sse2(
+    __m128i v)
+{
+    /* Even bytes are high nibbles, odd bytes are low nibbles */
+    return _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v,
+        _mm_set1_epi16(0x00ff)), 4), _mm_srli_epi16(v, 8));
+}
+
+static
+gboolean
+binder_hex_decode_sse2(
+    const char* hex,
+    gsize len,
+    guint8* out)
+{
+    __m128i bad = _mm_setzero_si128();
+    gsize i;
+
+    for (i = 0; i + 32 <= len; i += 32) {
+        const __m128i a = binder_hex_nibbles_sse2(_mm_loadu_si128((const
+            __m128i*)(hex + i)), &bad);
+        const __m128i b = binder_hex_nibbles_sse2(_mm_loadu_si128((const
+            __m128i*)(hex + i + 16)), &bad);
+
+        _mm_storeu_si128((__m128i*)(out + i / 2), _mm_packus_epi16(
+            binder_hex_pairs_sse2(a), binder_hex_pairs_sse2(b)));
+    }
+    return !_mm_movemask_epi8(bad) &&
+        binder_hex_decode_scalar(hex + i, len - i, out + i / 2);
+}
+
+#  define binder_hex_encode_impl binder_hex_encode_sse2
+#  define binder_hex_decode_impl binder_hex_decode_sse2
+
+#endif /* BINDER_HEX_SSE2 */
+
+#ifdef BINDER_HEX_NEON
+
+static
+void
+binder_hex_encode_neon(
+    const guint8* in,
+    gsize size,
+    char* out,
+    gboolean lower)
+{
+    const uint8x16_t mask = vdupq_n_u8(0x0f);
+    const uint8x16_t nine = vdupq_n_u8(9);
+    const uint8x16_t zero = vdupq_n_u8('0');
+    const uint8x16_t alpha = vdupq_n_u8((lower ? 'a' : 'A') - '0' - 10);
+    gsize i;
+
+    for (i = 0; i + 16 <= size; i += 16) {
+        const uint8x16_t b = vld1q_u8(in + i);
+        const uint8x16_t hi = vshrq_n_u8(b, 4);
+        const uint8x16_t lo = vandq_u8(b, mask);
+        uint8x16x2_t pairs;
+
+        pairs.val[0] = vaddq_u8(vaddq_u8(hi, zero),
+            vandq_u8(vcgtq_u8(hi, nine), alpha));
+        pairs.val[1] = vaddq_u8(vaddq_u8(lo, zero),
+            vandq_u8(vcgtq_u8(lo, nine), alpha));
+
+        /* Interleaving store puts each high digit before its low one */
+        vst2q_u8((uint8_t*)(out + 2 * i), pairs);
+    }
+    binder_hex_encode_scalar(in + i, size - i, out + 2 * i, lower);
+}
+
+static inline
+uint8x16_t
+binder_hex_nibbles_neon(
+    uint8x16_t c,
+    uint8x16_t* bad)
+{
+    const uint8x16_t d = vsubq_u8(c, vdupq_n_u8('0'));
+    const uint8x16_t a = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)),
+        vdupq_n_u8('a'));
+    const uint8x16_t is_digit = vcleq_u8(d, vdupq_n_u8(9));
+    const uint8x16_t is_alpha = vcleq_u8(a, vdupq_n_u8(5));
+
+    *bad = vorrq_u8(*bad, vmvnq_u8(vorrq_u8(is_digit, is_alpha)));
+    return vorrq_u8(vandq_u8(is_digit, d), vandq_u8(is_alpha,
+        vaddq_u8(a, vdupq_n_u8(10))));
+}
+
+static
+gboolean
+binder_hex_decode_neon(
+    const char* hex,
+    gsize len,
+    guint8* out)
+{
+    uint8x16_t bad = vdupq_n_u8(0);
+    uint8x8_t any;
+    gsize i;
+
+    for (i = 0; i + 32 <= len; i += 32) {
+        /* De-interleaving load splits high and low digits */
+        const uint8x16x2_t c = vld2q_u8((const uint8_t*)(hex + i));
+        const uint8x16_t hi = binder_hex_nibbles_neon(c.val[0], &bad);
+        const uint8x16_t lo = binder_hex_nibbles_neon(c.val[1], &bad);
+
+        vst1q_u8(out + i / 2, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+    }
+    any = vorr_u8(vget_low_u8(bad), vget_high_u8(bad));
+    return !vget_lane_u64(vreinterpret_u64_u8(any), 0) &&
+        binder_hex_decode_scalar(hex + i, len - i, out + i / 2);
+}
+
+#  define binder_hex_encode_impl binder_hex_encode_neon
+#  define binder_hex_decode_impl binder_hex_decode_neon
+
+#endif /* BINDER_HEX_NEON */
+
+/*
+ * The kernel is picked at compile time. SSE2 and NEON are only used when
+ * the compiler targets them, and then the rest of the binary requires
+ * them anyway, so there's nothing left to check at runtime.
+ */
+#ifndef binder_hex_encode_impl
+#  define binder_hex_encode_impl binder_hex_encode_scalar
+#  define binder_hex_decode_impl binder_hex_decode_scalar
+#endif
+
+char*
+binder_hex_encode(
+    const void* in,
+    gsize size,
+    char* out,
+    gboolean lower)
+{
+    binder_hex_encode_impl(in, size, out, lower);
+    out[size * 2] = 0;
+    return out;
+}
+
+gboolean
+binder_hex_decode(
+    const char* hex,
+    gsize len,
+    void* out)
+{
+    return !(len & 1) && binder_hex_decode_impl(hex, len, out);
+}
+
+/*
+ * The PDU starts with the SMSC address which is prefixed by its own
+ * length octet (TS 24.008 10.5.4.9). An empty SMSC (length octet 0) is
+ * sent as an empty string which makes the modem use the default one.
+ */
+static
+gsize
+binder_ims_gsm_sms_smsc_len(
+    const guint8* pdu,
+    gsize pdu_len)
+{
+    return (pdu_len && pdu[0] < pdu_len) ? (pdu[0] + 1) : 0;
+}
+
+gsize
+binder_ims_gsm_sms_size(
+    const guint8* pdu,
+    gsize pdu_len)
+{
+    const gsize smsc_len = binder_ims_gsm_sms_smsc_len(pdu, pdu_len);
+    const gsize smsc_hex_len = (smsc_len > 1) ? (smsc_len * 2) : 0;
+
+    return G_ALIGN8(sizeof(RadioImsSmsMessage)) +
+        G_ALIGN8(sizeof(RadioGsmSmsMessage)) +
+        G_ALIGN8(smsc_hex_len + 1) + (pdu_len - smsc_len) * 2 + 1;
+}
+
+RadioImsSmsMessage*
+binder_ims_gsm_sms_init(
+    void* buf,
+    const guint8* pdu,
+    gsize pdu_len)
+{
+    const gsize smsc_len = binder_ims_gsm_sms_smsc_len(pdu, pdu_len);
+    const gsize tpdu_len = pdu_len - smsc_len;
+    const gsize smsc_hex_len = (smsc_len > 1) ? (smsc_len * 2) : 0;
+    const gsize ims_size = G_ALIGN8(sizeof(RadioImsSmsMessage));
+    const gsize gsm_size = G_ALIGN8(sizeof(RadioGsmSmsMessage));
+    RadioImsSmsMessage* ims = buf;
+    RadioGsmSmsMessage* gsm = (RadioGsmSmsMessage*)((guint8*)buf +
+        ims_size);
+    char* smsc_hex = (char*)buf + ims_size + gsm_size;
+    char* tpdu_hex = smsc_hex + G_ALIGN8(smsc_hex_len + 1);
+
+    /* PDU is sent as an ASCII hex string */
+    binder_hex_encode(pdu, smsc_hex_len / 2, smsc_hex, FALSE);
+    binder_hex_encode(pdu + smsc_len, tpdu_len, tpdu_hex, FALSE);
+
+    gsm->smscPdu.data.str = smsc_hex;
+    gsm->smscPdu.len = smsc_hex_len;
+    gsm->smscPdu.owns_buffer = TRUE;
+    gsm->pdu.data.str = tpdu_hex;
+    gsm->pdu.len = tpdu_len * 2;
+    gsm->pdu.owns_buffer = TRUE;
+
+    ims->tech = RADIO_TECH_FAMILY_3GPP2;
+    ims->gsmMessage.count = 1;
+    ims->gsmMessage.data.ptr = gsm;
+    ims->gsmMessage.owns_buffer = TRUE;
+    return ims;
+}
+
+void
+binder_copy_utf8(
+    char* buf,
+    gsize size,
+    const char* str)
+{
+    gsize len = 0;
+
+    while (str && *str) {
+        const gunichar c = g_utf8_get_char_validated(str, -1);
+
+        if (c == (gunichar)-1 || c == (gunichar)-2) {
+            if (len + 1 >= size) {
+                break;
+            }
+            buf[len++] = '?';
+            str++;
+        } else {
+            const char* next = g_utf8_next_char(str);
+            const gsize n = next - str;
+
+            if (len + n >= size) {
+                break;
+            }
+            memcpy(buf + len, str, n);
+            len += n;
+            str = next;
+        }
+    }
+    buf[len] = 0;
+}
+
 char*
 binder_encode_hex(
     const void* in,
     guint size)
 {
-    char *out = g_new(char, size * 2 + 1);
-
-    ofono_encode_hex(in, size, out);
-    return out;
+    /* Upper case, same as ofono_encode_hex() */
+    return binder_hex_encode(in, size, g_new(char, size * 2 + 1), FALSE);
 }
 
 void*
@@ -674,7 +1054,7 @@ binder_decode_hex(
         if (len > 0 && !(len & 1)) {
             size = len/2;
             out = g_malloc(size);
-            if (!gutil_hex2bin(hex, len, out)) {
+            if (!binder_hex_decode(hex, len, out)) {
                 g_free(out);
                 out = NULL;
                 size = 0;
@@ -711,20 +1091,10 @@ binder_print_hex(
     gsize size)
 {
     if (data && size) {
-        const guint8* bytes = data;
         GUtilIdlePool* pool = gutil_idle_pool_get(&binder_util_pool);
-        char* str = g_new(char, size * 2 + 1);
-        char* ptr = str;
-        gsize i;
-
-        for (i = 0; i < size; i++) {
-            static const char hex[] = "0123456789abcdef";
-            const guint8 b = bytes[i];
+        char* str = binder_hex_encode(data, size, g_new(char, size * 2 + 1),
+            TRUE);
 
-            *ptr++ = hex[(b >> 4) & 0xf];
-            *ptr++ = hex[b & 0xf];
-        }
-        *ptr++ = 0;
         gutil_idle_pool_add(pool, str, g_free);
         return str;
     }
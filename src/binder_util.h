@@ -157,6 +157,51 @@ binder_parse_mcc_mnc(
     struct ofono_network_operator* op)
     BINDER_INTERNAL;
 
+char*
+binder_hex_encode(
+    const void* in,
+    gsize size,
+    char* out,
+    gboolean lower)
+    BINDER_INTERNAL;
+
+gboolean
+binder_hex_decode(
+    const char* hex,
+    gsize len,
+    void* out)
+    BINDER_INTERNAL;
+
+/*
+ * RadioImsSmsMessage with a single RadioGsmSmsMessage and both hex
+ * strings, laid out in one buffer of binder_ims_gsm_sms_size() bytes.
+ * The buffer must be 8-byte aligned and zeroed.
+ */
+gsize
+binder_ims_gsm_sms_size(
+    const guint8* pdu,
+    gsize pdu_len)
+    BINDER_INTERNAL;
+
+RadioImsSmsMessage*
+binder_ims_gsm_sms_init(
+    void* buf,
+    const guint8* pdu,
+    gsize pdu_len)
+    BINDER_INTERNAL;
+
+/*
+ * Copies valid UTF-8 into a buffer of the given size, always NUL
+ * terminated. Invalid bytes become '?', truncation never splits
+ * a character.
+ */
+void
+binder_copy_utf8(
+    char* buf,
+    gsize size,
+    const char* str)
+    BINDER_INTERNAL;
+
 char*
 binder_encode_hex(
     const void* in,
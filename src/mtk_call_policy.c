@@ -0,0 +1,212 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include "mtk_call_policy.h"
+
+#include <ofono/log.h>
+
+#include <gutil_macros.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define MTK_CALL_POLICY_MAX_CALLS "maxCalls"
+#define MTK_CALL_POLICY_REJECT_WHEN_BUSY "rejectWhenBusy"
+#define MTK_CALL_POLICY_REJECT_WHEN_DSDS_BUSY "rejectWhenDsdsBusy"
+#define MTK_CALL_POLICY_BLOCKED_NUMBERS "blockedNumbers"
+
+struct mtk_call_policy {
+    guint max_calls;
+    gboolean reject_when_busy;
+    gboolean reject_when_dsds_busy;
+    GHashTable* blocked;
+    MtkCallPolicyCallCountFunc call_count;
+    void* user_data;
+};
+
+/* All policies, one per slot */
+static GSList* mtk_call_policy_list = NULL;
+
+static
+char*
+mtk_call_policy_normalize(
+    const char* number)
+{
+    /* Keep the leading '+' and the digits, drop everything else */
+    char* out = g_malloc(strlen(number) + 1);
+    char* ptr = out;
+
+    if (*number == '+') {
+        *ptr++ = *number++;
+    }
+    for (; *number; number++) {
+        if (g_ascii_isdigit(*number)) {
+            *ptr++ = *number;
+        }
+    }
+    *ptr = 0;
+    return out;
+}
+
+static
+gboolean
+mtk_call_policy_param_bool(
+    GHashTable* params,
+    const char* key)
+{
+    const char* value = params ? g_hash_table_lookup(params, key) : NULL;
+
+    return value && (!g_ascii_strcasecmp(value, "true") ||
+        !g_ascii_strcasecmp(value, "on") || atoi(value) > 0);
+}
+
+static
+GHashTable*
+mtk_call_policy_parse_blocked(
+    const char* list)
+{
+    GHashTable* blocked = NULL;
+
+    if (list) {
+        char** numbers = g_strsplit_set(list, ",;", -1);
+        char** ptr;
+
+        for (ptr = numbers; *ptr; ptr++) {
+            char* number = mtk_call_policy_normalize(g_strstrip(*ptr));
+
+            if (*number) {
+                if (!blocked) {
+                    blocked = g_hash_table_new_full(g_str_hash, g_str_equal,
+                        g_free, NULL);
+                }
+                g_hash_table_add(blocked, number);
+            } else {
+                g_free(number);
+            }
+        }
+        g_strfreev(numbers);
+    }
+    return blocked;
+}
+
+static
+guint
+mtk_call_policy_call_count(
+    MtkCallPolicy* policy)
+{
+    return policy->call_count ? policy->call_count(policy->user_data) : 0;
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+MtkCallPolicy*
+mtk_call_policy_new(
+    GHashTable* params,
+    MtkCallPolicyCallCountFunc call_count,
+    void* user_data)
+{
+    MtkCallPolicy* policy = g_slice_new0(MtkCallPolicy);
+    const char* max_calls = params ? g_hash_table_lookup(params,
+        MTK_CALL_POLICY_MAX_CALLS) : NULL;
+
+    policy->max_calls = max_calls ? MAX(atoi(max_calls), 0) : 0;
+    policy->reject_when_busy = mtk_call_policy_param_bool(params,
+        MTK_CALL_POLICY_REJECT_WHEN_BUSY);
+    policy->reject_when_dsds_busy = mtk_call_policy_param_bool(params,
+        MTK_CALL_POLICY_REJECT_WHEN_DSDS_BUSY);
+    policy->blocked = mtk_call_policy_parse_blocked(params ?
+        g_hash_table_lookup(params, MTK_CALL_POLICY_BLOCKED_NUMBERS) : NULL);
+    policy->call_count = call_count;
+    policy->user_data = user_data;
+
+    DBG("maxCalls %u, rejectWhenBusy %d, rejectWhenDsdsBusy %d, "
+        "%u blocked number(s)", policy->max_calls, policy->reject_when_busy,
+        policy->reject_when_dsds_busy, policy->blocked ?
+        g_hash_table_size(policy->blocked) : 0);
+
+    mtk_call_policy_list = g_slist_append(mtk_call_policy_list, policy);
+    return policy;
+}
+
+void
+mtk_call_policy_free(
+    MtkCallPolicy* policy)
+{
+    if (policy) {
+        mtk_call_policy_list = g_slist_remove(mtk_call_policy_list, policy);
+        if (policy->blocked) {
+            g_hash_table_destroy(policy->blocked);
+        }
+        gutil_slice_free(policy);
+    }
+}
+
+gboolean
+mtk_call_policy_allow_incoming(
+    MtkCallPolicy* policy,
+    const char* number,
+    int* cause)
+{
+    if (G_LIKELY(policy)) {
+        guint own = 0, others = 0;
+        GSList* l;
+
+        if (policy->blocked && number && number[0]) {
+            char* normalized = mtk_call_policy_normalize(number);
+            const gboolean blocked = g_hash_table_contains(policy->blocked,
+                normalized);
+
+            g_free(normalized);
+            if (blocked) {
+                *cause = MTK_CALL_POLICY_CAUSE_CALL_REJECTED;
+                return FALSE;
+            }
+        }
+
+        if (!policy->max_calls && !policy->reject_when_busy &&
+            !policy->reject_when_dsds_busy) {
+            /* Nothing else to check */
+            return TRUE;
+        }
+
+        for (l = mtk_call_policy_list; l; l = l->next) {
+            MtkCallPolicy* p = l->data;
+
+            if (p == policy) {
+                own = mtk_call_policy_call_count(p);
+            } else {
+                others += mtk_call_policy_call_count(p);
+            }
+        }
+
+        if ((policy->reject_when_busy && own) ||
+            (policy->reject_when_dsds_busy && others) ||
+            (policy->max_calls && (own + others) >= policy->max_calls)) {
+            *cause = MTK_CALL_POLICY_CAUSE_USER_BUSY;
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,72 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#ifndef MTK_CALL_POLICY_H
+#define MTK_CALL_POLICY_H
+
+#include <glib.h>
+
+/*
+ * Incoming call admission policy. Each slot registers its own policy,
+ * all of them share the list of slots so that the state of the other
+ * slot can be taken into account on DSDS devices.
+ *
+ * Slot configuration keys:
+ *
+ *   maxCalls          - maximum number of calls on all slots (0 = any)
+ *   rejectWhenBusy    - reject if this slot already has a call
+ *   rejectWhenDsdsBusy - reject if another slot has a call
+ *   blockedNumbers    - numbers to reject, separated by ',' or ';'
+ *
+ * Everything is allowed by default.
+ */
+
+typedef struct mtk_call_policy MtkCallPolicy;
+
+typedef guint (*MtkCallPolicyCallCountFunc)(
+    void* user_data);
+
+/* TS 24.008 Table 10.5.123 */
+#define MTK_CALL_POLICY_CAUSE_USER_BUSY (17)
+#define MTK_CALL_POLICY_CAUSE_CALL_REJECTED (21)
+
+MtkCallPolicy*
+mtk_call_policy_new(
+    GHashTable* params,
+    MtkCallPolicyCallCountFunc call_count,
+    void* user_data)
+    G_GNUC_INTERNAL;
+
+void
+mtk_call_policy_free(
+    MtkCallPolicy* policy)
+    G_GNUC_INTERNAL;
+
+gboolean
+mtk_call_policy_allow_incoming(
+    MtkCallPolicy* policy,
+    const char* number,
+    int* cause)
+    G_GNUC_INTERNAL;
+
+#endif /* MTK_CALL_POLICY_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,293 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include "mtk_cdr.h"
+
+#include <ofono/log.h>
+
+#include <string.h>
+
+typedef struct mtk_cdr_timeline {
+    MtkCdrRecord record;
+    gint64 start; /* Monotonic time of the first event */
+    gint64 time[MTK_CDR_EVENT_COUNT]; /* Monotonic, zero if not seen */
+} MtkCdrTimeline;
+
+struct mtk_cdr {
+    GHashTable* calls; /* call_id => MtkCdrTimeline */
+    MtkCdrRecord* ring;
+    guint size;
+    guint first;
+    guint count;
+    guint total;
+    guint failed;
+    MtkCdrRecordFunc record_func;
+    void* record_data;
+};
+
+#define ID_KEY(id) GUINT_TO_POINTER(id)
+
+static
+void
+mtk_cdr_timeline_init(
+    MtkCdrTimeline* call,
+    guint call_id)
+{
+    memset(call, 0, sizeof(*call));
+    call->record.call_id = call_id;
+    call->record.rat = MTK_CDR_UNKNOWN;
+    call->record.codec = MTK_CDR_UNKNOWN;
+    call->record.cause = MTK_CDR_UNKNOWN;
+}
+
+static
+MtkCdrTimeline*
+mtk_cdr_timeline(
+    MtkCdr* cdr,
+    guint call_id)
+{
+    MtkCdrTimeline* call = g_hash_table_lookup(cdr->calls, ID_KEY(call_id));
+
+    if (!call) {
+        call = g_new(MtkCdrTimeline, 1);
+        mtk_cdr_timeline_init(call, call_id);
+        g_hash_table_insert(cdr->calls, ID_KEY(call_id), call);
+    }
+    return call;
+}
+
+static
+void
+mtk_cdr_finish(
+    MtkCdrTimeline* call,
+    MtkCdrRecord* record)
+{
+    guint i;
+
+    /* Times become small offsets from the start of the call */
+    *record = call->record;
+    record->start = g_get_real_time() - (g_get_monotonic_time() -
+        call->start);
+    for (i = 0; i < MTK_CDR_EVENT_COUNT; i++) {
+        record->time[i] = call->time[i] ?
+            (gint32)((call->time[i] - call->start) / 1000) :
+            MTK_CDR_NO_TIME;
+    }
+}
+
+static
+void
+mtk_cdr_add(
+    MtkCdr* cdr,
+    MtkCdrTimeline* call)
+{
+    MtkCdrRecord* record;
+
+    /* Overwrite the oldest record when the ring is full */
+    if (cdr->count < cdr->size) {
+        record = cdr->ring + (cdr->first + cdr->count++) % cdr->size;
+    } else {
+        record = cdr->ring + cdr->first;
+        cdr->first = (cdr->first + 1) % cdr->size;
+    }
+    mtk_cdr_finish(call, record);
+
+    cdr->total++;
+    if (record->time[MTK_CDR_EVENT_CONNECTED] == MTK_CDR_NO_TIME) {
+        cdr->failed++;
+    }
+    DBG("call %u %s, cause %d, %u/%u call(s) never connected",
+        record->call_id, record->incoming ? "in" : "out", record->cause,
+        cdr->failed, cdr->total);
+
+    if (cdr->record_func) {
+        cdr->record_func(record, cdr->record_data);
+    }
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+MtkCdr*
+mtk_cdr_new(
+    guint size)
+{
+    MtkCdr* cdr = g_new0(MtkCdr, 1);
+
+    cdr->calls = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+        NULL, g_free);
+    cdr->size = MAX(size, 1);
+    cdr->ring = g_new(MtkCdrRecord, cdr->size);
+    return cdr;
+}
+
+void
+mtk_cdr_free(
+    MtkCdr* cdr)
+{
+    if (cdr) {
+        g_hash_table_destroy(cdr->calls);
+        g_free(cdr->ring);
+        g_free(cdr);
+    }
+}
+
+void
+mtk_cdr_set_record_func(
+    MtkCdr* cdr,
+    MtkCdrRecordFunc func,
+    void* user_data)
+{
+    if (G_LIKELY(cdr)) {
+        cdr->record_func = func;
+        cdr->record_data = user_data;
+    }
+}
+
+void
+mtk_cdr_event(
+    MtkCdr* cdr,
+    guint call_id,
+    MTK_CDR_EVENT event,
+    gint64 when)
+{
+    if (G_LIKELY(cdr) && event < MTK_CDR_EVENT_COUNT) {
+        MtkCdrTimeline* call = mtk_cdr_timeline(cdr, call_id);
+
+        if (!when) {
+            when = g_get_monotonic_time();
+        }
+
+        /*
+         * A call can only start once. If it starts again, the id has
+         * been reused and the previous call's end has been missed.
+         */
+        if (call->time[event] && (event == MTK_CDR_EVENT_INCOMING ||
+            event == MTK_CDR_EVENT_SETUP ||
+            event == MTK_CDR_EVENT_ID_ASSIGNED)) {
+            DBG("call %u has started again, dropping its timeline", call_id);
+            mtk_cdr_timeline_init(call, call_id);
+        }
+
+        /* Only the first occurrence counts */
+        if (!call->time[event]) {
+            call->time[event] = when;
+            if (!call->start || when < call->start) {
+                call->start = when;
+            }
+        }
+    }
+}
+
+void
+mtk_cdr_set_incoming(
+    MtkCdr* cdr,
+    guint call_id,
+    gboolean incoming)
+{
+    if (G_LIKELY(cdr)) {
+        mtk_cdr_timeline(cdr, call_id)->record.incoming = incoming;
+    }
+}
+
+void
+mtk_cdr_set_rat(
+    MtkCdr* cdr,
+    int rat)
+{
+    if (G_LIKELY(cdr)) {
+        GHashTableIter it;
+        gpointer value;
+
+        g_hash_table_iter_init(&it, cdr->calls);
+        while (g_hash_table_iter_next(&it, NULL, &value)) {
+            ((MtkCdrTimeline*)value)->record.rat = rat;
+        }
+    }
+}
+
+void
+mtk_cdr_set_codec(
+    MtkCdr* cdr,
+    int codec)
+{
+    if (G_LIKELY(cdr)) {
+        GHashTableIter it;
+        gpointer value;
+
+        g_hash_table_iter_init(&it, cdr->calls);
+        while (g_hash_table_iter_next(&it, NULL, &value)) {
+            ((MtkCdrTimeline*)value)->record.codec = codec;
+        }
+    }
+}
+
+void
+mtk_cdr_disconnected(
+    MtkCdr* cdr,
+    guint call_id,
+    int cause)
+{
+    /* Nothing to record if the call has already been completed */
+    if (G_LIKELY(cdr) && g_hash_table_contains(cdr->calls, ID_KEY(call_id))) {
+        MtkCdrTimeline* call;
+
+        mtk_cdr_event(cdr, call_id, MTK_CDR_EVENT_DISCONNECTED, 0);
+        call = g_hash_table_lookup(cdr->calls, ID_KEY(call_id));
+        call->record.cause = cause;
+        mtk_cdr_add(cdr, call);
+        g_hash_table_remove(cdr->calls, ID_KEY(call_id));
+    }
+}
+
+void
+mtk_cdr_dial_failed(
+    MtkCdr* cdr,
+    gint64 dial_time)
+{
+    if (G_LIKELY(cdr)) {
+        MtkCdrTimeline call;
+
+        mtk_cdr_timeline_init(&call, 0);
+        call.start = call.time[MTK_CDR_EVENT_DIAL] = dial_time;
+        call.time[MTK_CDR_EVENT_DISCONNECTED] = g_get_monotonic_time();
+        mtk_cdr_add(cdr, &call);
+    }
+}
+
+guint
+mtk_cdr_count(
+    MtkCdr* cdr)
+{
+    return G_LIKELY(cdr) ? cdr->count : 0;
+}
+
+const MtkCdrRecord*
+mtk_cdr_get(
+    MtkCdr* cdr,
+    guint i)
+{
+    return (G_LIKELY(cdr) && i < cdr->count) ?
+        (cdr->ring + (cdr->first + i) % cdr->size) : NULL;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,141 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#ifndef MTK_CDR_H
+#define MTK_CDR_H
+
+#include <glib.h>
+
+/*
+ * Call detail records. Each call collects a timeline while it's alive,
+ * which is turned into a compact record when the call disconnects.
+ * The most recent records are kept in a ring.
+ */
+
+typedef struct mtk_cdr MtkCdr;
+
+typedef enum mtk_cdr_event {
+    MTK_CDR_EVENT_INCOMING,     /* incomingCallIndication received */
+    MTK_CDR_EVENT_ALLOWED,      /* setCallIndication sent */
+    MTK_CDR_EVENT_DIAL,         /* dial sent */
+    MTK_CDR_EVENT_ID_ASSIGNED,  /* MO_CALL_ID_ASSIGN */
+    MTK_CDR_EVENT_SETUP,        /* +ECPI SETUP */
+    MTK_CDR_EVENT_ALERTING,     /* +ECPI ALERT */
+    MTK_CDR_EVENT_ANSWER,       /* acceptCall sent */
+    MTK_CDR_EVENT_CONNECTED,    /* +ECPI CONNECTED */
+    MTK_CDR_EVENT_DISCONNECTED, /* +ECPI DISCONNECTED */
+    MTK_CDR_EVENT_COUNT
+} MTK_CDR_EVENT;
+
+#define MTK_CDR_NO_TIME (-1)
+#define MTK_CDR_UNKNOWN (-1)
+
+typedef struct mtk_cdr_record {
+    guint call_id;
+    gboolean incoming;
+    gint64 start; /* Wall clock time of the first event, microseconds */
+    gint32 time[MTK_CDR_EVENT_COUNT]; /* ms since start or MTK_CDR_NO_TIME */
+    int rat;   /* Last callRatIndication rat or MTK_CDR_UNKNOWN */
+    int codec; /* Last speechCodecInfoIndication info or MTK_CDR_UNKNOWN */
+    int cause; /* Disconnect cause or MTK_CDR_UNKNOWN */
+} MtkCdrRecord;
+
+typedef void (*MtkCdrRecordFunc)(
+    const MtkCdrRecord* record,
+    void* user_data);
+
+MtkCdr*
+mtk_cdr_new(
+    guint size)
+    G_GNUC_INTERNAL;
+
+void
+mtk_cdr_free(
+    MtkCdr* cdr)
+    G_GNUC_INTERNAL;
+
+/* Called for each new record */
+void
+mtk_cdr_set_record_func(
+    MtkCdr* cdr,
+    MtkCdrRecordFunc func,
+    void* user_data)
+    G_GNUC_INTERNAL;
+
+/* when is the monotonic time, zero means now */
+void
+mtk_cdr_event(
+    MtkCdr* cdr,
+    guint call_id,
+    MTK_CDR_EVENT event,
+    gint64 when)
+    G_GNUC_INTERNAL;
+
+void
+mtk_cdr_set_incoming(
+    MtkCdr* cdr,
+    guint call_id,
+    gboolean incoming)
+    G_GNUC_INTERNAL;
+
+/* RAT and codec are not reported per call, they apply to all calls */
+void
+mtk_cdr_set_rat(
+    MtkCdr* cdr,
+    int rat)
+    G_GNUC_INTERNAL;
+
+void
+mtk_cdr_set_codec(
+    MtkCdr* cdr,
+    int codec)
+    G_GNUC_INTERNAL;
+
+/* Completes the record, also for incoming calls which have been rejected */
+void
+mtk_cdr_disconnected(
+    MtkCdr* cdr,
+    guint call_id,
+    int cause)
+    G_GNUC_INTERNAL;
+
+/* Records a dial which has failed before getting a call id (zero) */
+void
+mtk_cdr_dial_failed(
+    MtkCdr* cdr,
+    gint64 dial_time)
+    G_GNUC_INTERNAL;
+
+guint
+mtk_cdr_count(
+    MtkCdr* cdr)
+    G_GNUC_INTERNAL;
+
+/* Zero is the oldest record */
+const MtkCdrRecord*
+mtk_cdr_get(
+    MtkCdr* cdr,
+    guint i)
+    G_GNUC_INTERNAL;
+
+#endif /* MTK_CDR_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,497 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include "mtk_conf_info.h"
+#include "binder_util.h"
+
+#include <ofono/log.h>
+
+#include <gutil_macros.h>
+
+#include <string.h>
+
+/*
+ * Tags and values are collected into fixed size buffers, nothing is
+ * allocated while parsing. Anything longer gets truncated, which is
+ * fine for the elements and attributes we are interested in.
+ */
+#define MTK_CONF_INFO_TAG_MAX (512)
+#define MTK_CONF_INFO_VALUE_MAX (256)
+
+typedef enum mtk_conf_info_text {
+    MTK_CONF_INFO_TEXT_NONE,
+    MTK_CONF_INFO_TEXT_DISPLAY,
+    MTK_CONF_INFO_TEXT_STATUS
+} MTK_CONF_INFO_TEXT;
+
+typedef struct mtk_conf_info_participant {
+    MtkConfParticipant pub;
+    char* entity;
+    char* display_text;
+    guint generation;
+} MtkConfInfoParticipant;
+
+struct mtk_conf_info {
+    GHashTable* participants; /* entity => MtkConfInfoParticipant */
+    MtkConfInfoChangeFunc changed;
+    void* user_data;
+    guint generation;
+    gboolean full;
+
+    /* Parser state, survives chunk boundaries */
+    gboolean in_tag;
+    char quote;
+    gsize tag_len;
+    char tag[MTK_CONF_INFO_TAG_MAX];
+    MTK_CONF_INFO_TEXT text_type;
+    gsize text_len;
+    char text[MTK_CONF_INFO_VALUE_MAX];
+
+    /* Current <user> element */
+    gboolean in_user;
+    gboolean in_endpoint;
+    gboolean user_deleted;
+    gboolean have_display_text;
+    MTK_CONF_PARTICIPANT_STATUS user_status;
+    char user_entity[MTK_CONF_INFO_VALUE_MAX];
+    char user_display_text[MTK_CONF_INFO_VALUE_MAX];
+};
+
+static const struct mtk_conf_info_status_name {
+    const char* name;
+    MTK_CONF_PARTICIPANT_STATUS status;
+} mtk_conf_info_status_names[] = {
+    { "connected", MTK_CONF_PARTICIPANT_CONNECTED },
+    { "disconnected", MTK_CONF_PARTICIPANT_DISCONNECTED },
+    { "on-hold", MTK_CONF_PARTICIPANT_ON_HOLD },
+    { "muted-via-focus", MTK_CONF_PARTICIPANT_CONNECTED },
+    { "pending", MTK_CONF_PARTICIPANT_PENDING },
+    { "alerting", MTK_CONF_PARTICIPANT_ALERTING },
+    { "dialing-in", MTK_CONF_PARTICIPANT_PENDING },
+    { "dialing-out", MTK_CONF_PARTICIPANT_DIALING_OUT },
+    { "disconnecting", MTK_CONF_PARTICIPANT_DISCONNECTING }
+};
+
+static
+void
+mtk_conf_info_participant_free(
+    gpointer data)
+{
+    MtkConfInfoParticipant* p = data;
+
+    g_free(p->entity);
+    g_free(p->display_text);
+    gutil_slice_free(p);
+}
+
+static
+void
+mtk_conf_info_unescape(
+    char* str)
+{
+    static const struct mtk_conf_info_entity {
+        const char* name;
+        gsize len;
+        char c;
+    } entities[] = {
+        { "&amp;", 5, '&' },
+        { "&lt;", 4, '<' },
+        { "&gt;", 4, '>' },
+        { "&quot;", 6, '"' },
+        { "&apos;", 6, '\'' }
+    };
+    char* out = str;
+
+    while (*str) {
+        if (*str == '&') {
+            guint i;
+
+            for (i = 0; i < G_N_ELEMENTS(entities); i++) {
+                if (!strncmp(str, entities[i].name, entities[i].len)) {
+                    break;
+                }
+            }
+            if (i < G_N_ELEMENTS(entities)) {
+                *out++ = entities[i].c;
+                str += entities[i].len;
+                continue;
+            }
+        }
+        *out++ = *str++;
+    }
+    *out = 0;
+}
+
+static
+void
+mtk_conf_info_copy_value(
+    char* dest,
+    const char* src,
+    gsize len)
+{
+    /* Escaped values are longer, unescape before truncating */
+    char raw[MTK_CONF_INFO_VALUE_MAX * 2];
+
+    len = MIN(len, sizeof(raw) - 1);
+    memcpy(raw, src, len);
+    raw[len] = 0;
+    mtk_conf_info_unescape(raw);
+
+    /* It's from the network and ends up on D-Bus */
+    binder_copy_utf8(dest, MTK_CONF_INFO_VALUE_MAX, raw);
+}
+
+static
+gboolean
+mtk_conf_info_attr(
+    const char* tag,
+    const char* name,
+    char* value)
+{
+    const gsize name_len = strlen(name);
+    const char* ptr = tag;
+
+    while ((ptr = strstr(ptr, name)) != NULL) {
+        const char* eq = ptr + name_len;
+
+        /* Must be a whole attribute name followed by ="..." */
+        if (ptr > tag && g_ascii_isspace(ptr[-1]) && eq[0] == '=' &&
+            (eq[1] == '"' || eq[1] == '\'')) {
+            const char* start = eq + 2;
+            const char* end = strchr(start, eq[1]);
+
+            if (end) {
+                mtk_conf_info_copy_value(value, start, end - start);
+                return TRUE;
+            }
+        }
+        ptr = eq;
+    }
+    value[0] = 0;
+    return FALSE;
+}
+
+static
+MTK_CONF_PARTICIPANT_STATUS
+mtk_conf_info_parse_status(
+    const char* str)
+{
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS(mtk_conf_info_status_names); i++) {
+        if (!strcmp(str, mtk_conf_info_status_names[i].name)) {
+            return mtk_conf_info_status_names[i].status;
+        }
+    }
+    return MTK_CONF_PARTICIPANT_UNKNOWN;
+}
+
+static
+void
+mtk_conf_info_remove(
+    MtkConfInfo* info,
+    MtkConfInfoParticipant* p)
+{
+    DBG("%s left", p->entity);
+    if (info->changed) {
+        info->changed(&p->pub, TRUE, info->user_data);
+    }
+    g_hash_table_remove(info->participants, p->entity);
+}
+
+static
+void
+mtk_conf_info_user_done(
+    MtkConfInfo* info)
+{
+    const char* entity = info->user_entity;
+    MtkConfInfoParticipant* p;
+    gboolean changed = FALSE;
+
+    if (!entity[0]) {
+        return;
+    }
+
+    p = g_hash_table_lookup(info->participants, entity);
+    if (info->user_deleted) {
+        if (p) {
+            mtk_conf_info_remove(info, p);
+        }
+        return;
+    }
+
+    if (!p) {
+        p = g_slice_new0(MtkConfInfoParticipant);
+        p->pub.entity = p->entity = g_strdup(entity);
+        g_hash_table_insert(info->participants, p->entity, p);
+        changed = TRUE;
+    }
+    p->generation = info->generation;
+
+    /* Partial notifications may leave the display text out */
+    if (info->have_display_text &&
+        g_strcmp0(p->display_text, info->user_display_text)) {
+        g_free(p->display_text);
+        p->pub.display_text = p->display_text =
+            g_strdup(info->user_display_text);
+        changed = TRUE;
+    }
+    if (info->user_status != MTK_CONF_PARTICIPANT_UNKNOWN &&
+        p->pub.status != info->user_status) {
+        p->pub.status = info->user_status;
+        changed = TRUE;
+    }
+
+    if (changed) {
+        DBG("%s status %d", p->entity, p->pub.status);
+        if (info->changed) {
+            info->changed(&p->pub, FALSE, info->user_data);
+        }
+    }
+}
+
+static
+void
+mtk_conf_info_document_done(
+    MtkConfInfo* info)
+{
+    if (info->full) {
+        /* Whoever wasn't mentioned in a full document is gone */
+        GHashTableIter it;
+        gpointer value;
+        GSList* gone = NULL;
+
+        g_hash_table_iter_init(&it, info->participants);
+        while (g_hash_table_iter_next(&it, NULL, &value)) {
+            MtkConfInfoParticipant* p = value;
+
+            if (p->generation != info->generation) {
+                gone = g_slist_prepend(gone, p);
+            }
+        }
+        while (gone) {
+            mtk_conf_info_remove(info, gone->data);
+            gone = g_slist_delete_link(gone, gone);
+        }
+    }
+}
+
+static
+void
+mtk_conf_info_tag(
+    MtkConfInfo* info)
+{
+    char* tag = info->tag;
+    gsize len = info->tag_len;
+    gboolean closing = FALSE, empty = FALSE;
+    const char* name;
+    const char* colon;
+    gsize name_len;
+    char value[MTK_CONF_INFO_VALUE_MAX];
+
+    if (!len || tag[0] == '?' || tag[0] == '!') {
+        /* Declaration, comment or whatever */
+        return;
+    }
+
+    tag[len] = 0;
+    if (tag[0] == '/') {
+        closing = TRUE;
+        tag++;
+    } else if (tag[len - 1] == '/') {
+        empty = TRUE;
+        tag[--len] = 0;
+    }
+
+    /* Element name without the namespace prefix */
+    name_len = strcspn(tag, " \t\r\n");
+    colon = memchr(tag, ':', name_len);
+    name = colon ? (colon + 1) : tag;
+    name_len -= (name - tag);
+
+#define MTK_CONF_INFO_IS(str) \
+    (name_len == sizeof(str) - 1 && !memcmp(name, str, name_len))
+
+    if (closing) {
+        if (MTK_CONF_INFO_IS("display-text") || MTK_CONF_INFO_IS("status")) {
+            info->text[info->text_len] = 0;
+            if (info->text_type == MTK_CONF_INFO_TEXT_DISPLAY) {
+                mtk_conf_info_copy_value(info->user_display_text,
+                    info->text, info->text_len);
+                info->have_display_text = TRUE;
+            } else if (info->text_type == MTK_CONF_INFO_TEXT_STATUS) {
+                mtk_conf_info_copy_value(value, info->text, info->text_len);
+                info->user_status = mtk_conf_info_parse_status(g_strstrip(
+                    value));
+            }
+            info->text_type = MTK_CONF_INFO_TEXT_NONE;
+        } else if (MTK_CONF_INFO_IS("endpoint")) {
+            info->in_endpoint = FALSE;
+        } else if (MTK_CONF_INFO_IS("user")) {
+            mtk_conf_info_user_done(info);
+            info->in_user = FALSE;
+        } else if (MTK_CONF_INFO_IS("conference-info")) {
+            mtk_conf_info_document_done(info);
+        }
+    } else if (MTK_CONF_INFO_IS("conference-info")) {
+        /* The state attribute defaults to "full" */
+        info->full = !mtk_conf_info_attr(tag, "state", value) ||
+            !strcmp(value, "full");
+        info->generation++;
+    } else if (MTK_CONF_INFO_IS("user")) {
+        info->in_user = TRUE;
+        info->in_endpoint = FALSE;
+        info->have_display_text = FALSE;
+        info->user_status = MTK_CONF_PARTICIPANT_UNKNOWN;
+        info->user_display_text[0] = 0;
+        mtk_conf_info_attr(tag, "entity", info->user_entity);
+        info->user_deleted = mtk_conf_info_attr(tag, "state", value) &&
+            !strcmp(value, "deleted");
+        if (empty) {
+            mtk_conf_info_user_done(info);
+            info->in_user = FALSE;
+        }
+    } else if (info->in_user && !empty) {
+        if (MTK_CONF_INFO_IS("endpoint")) {
+            info->in_endpoint = TRUE;
+        } else if (MTK_CONF_INFO_IS("display-text") && !info->in_endpoint) {
+            info->text_type = MTK_CONF_INFO_TEXT_DISPLAY;
+            info->text_len = 0;
+        } else if (MTK_CONF_INFO_IS("status") && info->in_endpoint) {
+            info->text_type = MTK_CONF_INFO_TEXT_STATUS;
+            info->text_len = 0;
+        }
+    }
+
+#undef MTK_CONF_INFO_IS
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+MtkConfInfo*
+mtk_conf_info_new(
+    MtkConfInfoChangeFunc changed,
+    void* user_data)
+{
+    MtkConfInfo* info = g_new0(MtkConfInfo, 1);
+
+    info->participants = g_hash_table_new_full(g_str_hash, g_str_equal,
+        NULL, mtk_conf_info_participant_free);
+    info->changed = changed;
+    info->user_data = user_data;
+    return info;
+}
+
+void
+mtk_conf_info_free(
+    MtkConfInfo* info)
+{
+    if (info) {
+        g_hash_table_destroy(info->participants);
+        g_free(info);
+    }
+}
+
+void
+mtk_conf_info_begin(
+    MtkConfInfo* info)
+{
+    if (G_LIKELY(info)) {
+        info->in_tag = FALSE;
+        info->quote = 0;
+        info->tag_len = 0;
+        info->text_type = MTK_CONF_INFO_TEXT_NONE;
+        info->text_len = 0;
+        info->in_user = FALSE;
+        info->in_endpoint = FALSE;
+    }
+}
+
+void
+mtk_conf_info_feed(
+    MtkConfInfo* info,
+    const char* data,
+    gsize len)
+{
+    if (G_LIKELY(info)) {
+        const char* end = data + len;
+
+        for (; data < end; data++) {
+            const char c = *data;
+
+            if (info->in_tag) {
+                if (info->quote) {
+                    if (c == info->quote) {
+                        info->quote = 0;
+                    }
+                } else if (c == '"' || c == '\'') {
+                    info->quote = c;
+                } else if (c == '>') {
+                    info->in_tag = FALSE;
+                    mtk_conf_info_tag(info);
+                    continue;
+                }
+                /* Leave room for NUL */
+                if (info->tag_len < MTK_CONF_INFO_TAG_MAX - 1) {
+                    info->tag[info->tag_len++] = c;
+                }
+            } else if (c == '<') {
+                info->in_tag = TRUE;
+                info->tag_len = 0;
+            } else if (info->text_type != MTK_CONF_INFO_TEXT_NONE &&
+                info->text_len < MTK_CONF_INFO_VALUE_MAX - 1) {
+                info->text[info->text_len++] = c;
+            }
+        }
+    }
+}
+
+void
+mtk_conf_info_clear(
+    MtkConfInfo* info)
+{
+    if (G_LIKELY(info)) {
+        GHashTableIter it;
+        gpointer value;
+
+        g_hash_table_iter_init(&it, info->participants);
+        while (g_hash_table_iter_next(&it, NULL, &value)) {
+            MtkConfInfoParticipant* p = value;
+
+            if (info->changed) {
+                info->changed(&p->pub, TRUE, info->user_data);
+            }
+            g_hash_table_iter_remove(&it);
+        }
+        mtk_conf_info_begin(info);
+    }
+}
+
+guint
+mtk_conf_info_count(
+    MtkConfInfo* info)
+{
+    return G_LIKELY(info) ? g_hash_table_size(info->participants) : 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,95 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#ifndef MTK_CONF_INFO_H
+#define MTK_CONF_INFO_H
+
+#include <glib.h>
+
+/*
+ * Conference participant list maintained from RFC 4575 conference-info
+ * documents. The XML is parsed as it arrives, in chunks of any size,
+ * and only the participants which have actually changed are reported.
+ */
+
+typedef struct mtk_conf_info MtkConfInfo;
+
+/* RFC 4575 endpoint status */
+typedef enum mtk_conf_participant_status {
+    MTK_CONF_PARTICIPANT_UNKNOWN,
+    MTK_CONF_PARTICIPANT_PENDING,
+    MTK_CONF_PARTICIPANT_DIALING_OUT,
+    MTK_CONF_PARTICIPANT_ALERTING,
+    MTK_CONF_PARTICIPANT_CONNECTED,
+    MTK_CONF_PARTICIPANT_ON_HOLD,
+    MTK_CONF_PARTICIPANT_DISCONNECTING,
+    MTK_CONF_PARTICIPANT_DISCONNECTED
+} MTK_CONF_PARTICIPANT_STATUS;
+
+typedef struct mtk_conf_participant {
+    const char* entity;
+    const char* display_text;
+    MTK_CONF_PARTICIPANT_STATUS status;
+} MtkConfParticipant;
+
+typedef void (*MtkConfInfoChangeFunc)(
+    const MtkConfParticipant* participant,
+    gboolean removed,
+    void* user_data);
+
+MtkConfInfo*
+mtk_conf_info_new(
+    MtkConfInfoChangeFunc changed,
+    void* user_data)
+    G_GNUC_INTERNAL;
+
+void
+mtk_conf_info_free(
+    MtkConfInfo* info)
+    G_GNUC_INTERNAL;
+
+/* Starts a new document, discarding any incomplete one */
+void
+mtk_conf_info_begin(
+    MtkConfInfo* info)
+    G_GNUC_INTERNAL;
+
+void
+mtk_conf_info_feed(
+    MtkConfInfo* info,
+    const char* data,
+    gsize len)
+    G_GNUC_INTERNAL;
+
+/* Removes all participants */
+void
+mtk_conf_info_clear(
+    MtkConfInfo* info)
+    G_GNUC_INTERNAL;
+
+guint
+mtk_conf_info_count(
+    MtkConfInfo* info)
+    G_GNUC_INTERNAL;
+
+#endif /* MTK_CONF_INFO_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
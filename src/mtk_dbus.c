@@ -0,0 +1,944 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include "mtk_dbus.h"
+#include "mtk_cdr.h"
+#include "mtk_conf_info.h"
+#include "mtk_ims_call.h"
+#include "mtk_radio_ext.h"
+#include "mtk_radio_ext_types.h"
+#include "mtk_sip_log.h"
+#include "mtk_ssac.h"
+
+#include <ofono/log.h>
+
+#include <gio/gio.h>
+
+#include <gutil_misc.h>
+
+#define MTK_DBUS_SERVICE "org.ofono.mtk"
+#define MTK_DBUS_CALL_RECORDS_INTERFACE MTK_DBUS_SERVICE ".CallRecords"
+#define MTK_DBUS_BARRING_INTERFACE MTK_DBUS_SERVICE ".Barring"
+#define MTK_DBUS_SIP_EVENTS_INTERFACE MTK_DBUS_SERVICE ".SipEvents"
+#define MTK_DBUS_RADIO_INTERFACE MTK_DBUS_SERVICE ".Radio"
+#define MTK_DBUS_CALLS_INTERFACE MTK_DBUS_SERVICE ".Calls"
+
+#define MTK_DBUS_CDR_TYPE "(ubxaiiii)"
+#define MTK_DBUS_SSAC_TYPE "a(uuuuu)"
+#define MTK_DBUS_SIP_EVENT_TYPE "(xuibbiss)"
+#define MTK_DBUS_ACK_STATS_TYPE "(uuu)"
+#define MTK_DBUS_LATENCY_TYPE "(uxxx)"
+#define MTK_DBUS_CODEC_TYPE "(uiu)"
+#define MTK_DBUS_RAT_TYPE "(uiiuax)"
+#define MTK_DBUS_PARTICIPANT_TYPE "(ssub)"
+
+static const char mtk_dbus_introspection_xml[] =
+    "<node>"
+    "  <interface name='" MTK_DBUS_CALL_RECORDS_INTERFACE "'>"
+    "    <method name='GetRecords'>"
+    "      <arg name='records' type='a" MTK_DBUS_CDR_TYPE "' direction='out'/>"
+    "    </method>"
+    "    <signal name='RecordAdded'>"
+    "      <arg name='record' type='" MTK_DBUS_CDR_TYPE "'/>"
+    "    </signal>"
+    "  </interface>"
+    "  <interface name='" MTK_DBUS_BARRING_INTERFACE "'>"
+    "    <method name='GetStatus'>"
+    "      <arg name='status' type='" MTK_DBUS_SSAC_TYPE "' direction='out'/>"
+    "    </method>"
+    "    <signal name='StatusChanged'>"
+    "      <arg name='status' type='" MTK_DBUS_SSAC_TYPE "'/>"
+    "    </signal>"
+    "  </interface>"
+    "  <interface name='" MTK_DBUS_SIP_EVENTS_INTERFACE "'>"
+    "    <method name='GetEvents'>"
+    "      <arg name='events' type='a" MTK_DBUS_SIP_EVENT_TYPE "' direction='out'/>"
+    "    </method>"
+    "    <signal name='EventAdded'>"
+    "      <arg name='event' type='" MTK_DBUS_SIP_EVENT_TYPE "'/>"
+    "    </signal>"
+    "  </interface>"
+    "  <interface name='" MTK_DBUS_RADIO_INTERFACE "'>"
+    "    <method name='GetAckStats'>"
+    "      <arg name='stats' type='" MTK_DBUS_ACK_STATS_TYPE "' direction='out'/>"
+    "    </method>"
+    "    <method name='GetUnhandledIndications'>"
+    "      <arg name='counts' type='a(uu)' direction='out'/>"
+    "    </method>"
+    "    <method name='GetIncomingCallLatency'>"
+    "      <arg name='latency' type='" MTK_DBUS_LATENCY_TYPE "' direction='out'/>"
+    "    </method>"
+    "  </interface>"
+    "  <interface name='" MTK_DBUS_CALLS_INTERFACE "'>"
+    "    <method name='GetSpeechCodecs'>"
+    "      <arg name='codecs' type='a" MTK_DBUS_CODEC_TYPE "' direction='out'/>"
+    "    </method>"
+    "    <signal name='SpeechCodecChanged'>"
+    "      <arg name='codec' type='" MTK_DBUS_CODEC_TYPE "'/>"
+    "    </signal>"
+    "    <method name='GetRats'>"
+    "      <arg name='rats' type='a" MTK_DBUS_RAT_TYPE "' direction='out'/>"
+    "    </method>"
+    "    <method name='GetHandovers'>"
+    "      <arg name='handovers' type='au' direction='out'/>"
+    "    </method>"
+    "    <signal name='RatChanged'>"
+    "      <arg name='rat' type='" MTK_DBUS_RAT_TYPE "'/>"
+    "    </signal>"
+    "    <method name='GetAnswerLatency'>"
+    "      <arg name='latency' type='" MTK_DBUS_LATENCY_TYPE "' direction='out'/>"
+    "    </method>"
+    "    <method name='GetHoldLatency'>"
+    "      <arg name='latency' type='" MTK_DBUS_LATENCY_TYPE "' direction='out'/>"
+    "    </method>"
+    "    <method name='GetDialLatency'>"
+    "      <arg name='latency' type='a" MTK_DBUS_LATENCY_TYPE "' direction='out'/>"
+    "    </method>"
+    "    <method name='AddParticipant'>"
+    "      <arg name='address' type='s' direction='in'/>"
+    "    </method>"
+    "    <method name='RemoveParticipant'>"
+    "      <arg name='address' type='s' direction='in'/>"
+    "    </method>"
+    "    <signal name='ParticipantChanged'>"
+    "      <arg name='participant' type='" MTK_DBUS_PARTICIPANT_TYPE "'/>"
+    "    </signal>"
+    "  </interface>"
+    "</node>";
+
+enum mtk_dbus_ims_call_events {
+    IMS_CALL_EVENT_SPEECH_CODEC,
+    IMS_CALL_EVENT_RAT,
+    IMS_CALL_EVENT_CONF_PARTICIPANT,
+    IMS_CALL_EVENT_COUNT
+};
+
+/* The bus name is shared by all slots */
+typedef struct mtk_dbus_service {
+    int ref_count;
+    guint own_name_id;
+    GDBusConnection* connection;
+    GDBusNodeInfo* node;
+    GSList* objects;
+} MtkDbusService;
+
+struct mtk_dbus {
+    char* path;
+    MtkCdr* cdr;
+    guint cdr_reg_id;
+    MtkSsac* ssac;
+    guint ssac_reg_id;
+    MtkSipLog* sip_log;
+    guint sip_log_reg_id;
+    MtkRadioExt* radio_ext;
+    guint radio_ext_reg_id;
+    BinderExtCall* ims_call;
+    guint ims_call_reg_id;
+    gulong ims_call_event_id[IMS_CALL_EVENT_COUNT];
+};
+
+static MtkDbusService* mtk_dbus_service = NULL;
+
+static
+GVariant*
+mtk_dbus_cdr_variant(
+    const MtkCdrRecord* record)
+{
+    /* (call_id, incoming, start, event times, rat, codec, cause) */
+    return g_variant_new("(ubx@aiiii)", record->call_id, record->incoming,
+        record->start, g_variant_new_fixed_array(G_VARIANT_TYPE_INT32,
+        record->time, G_N_ELEMENTS(record->time), sizeof(record->time[0])),
+        record->rat, record->codec, record->cause);
+}
+
+static
+void
+mtk_dbus_cdr_method_call(
+    GDBusConnection* connection,
+    const char* sender,
+    const char* path,
+    const char* iface,
+    const char* method,
+    GVariant* params,
+    GDBusMethodInvocation* call,
+    gpointer user_data)
+{
+    MtkDbus* self = user_data;
+
+    if (!g_strcmp0(method, "GetRecords")) {
+        GVariantBuilder builder;
+        const guint n = mtk_cdr_count(self->cdr);
+        guint i;
+
+        g_variant_builder_init(&builder,
+            G_VARIANT_TYPE("a" MTK_DBUS_CDR_TYPE));
+        for (i = 0; i < n; i++) {
+            g_variant_builder_add_value(&builder,
+                mtk_dbus_cdr_variant(mtk_cdr_get(self->cdr, i)));
+        }
+        g_dbus_method_invocation_return_value(call,
+            g_variant_new("(@a" MTK_DBUS_CDR_TYPE ")",
+            g_variant_builder_end(&builder)));
+    } else {
+        g_dbus_method_invocation_return_error(call, G_DBUS_ERROR,
+            G_DBUS_ERROR_UNKNOWN_METHOD, "Unknown method %s", method);
+    }
+}
+
+static const GDBusInterfaceVTable mtk_dbus_cdr_vtable = {
+    mtk_dbus_cdr_method_call, NULL, NULL
+};
+
+static
+void
+mtk_dbus_cdr_added(
+    const MtkCdrRecord* record,
+    void* user_data)
+{
+    MtkDbus* self = user_data;
+
+    if (self->cdr_reg_id) {
+        g_dbus_connection_emit_signal(mtk_dbus_service->connection, NULL,
+            self->path, MTK_DBUS_CALL_RECORDS_INTERFACE, "RecordAdded",
+            g_variant_new("(@" MTK_DBUS_CDR_TYPE ")",
+            mtk_dbus_cdr_variant(record)), NULL);
+    }
+}
+
+/* Indexed by MTK_SSAC_CATEGORY */
+static
+GVariant*
+mtk_dbus_ssac_variant(
+    MtkSsac* ssac)
+{
+    GVariantBuilder builder;
+    int i;
+
+    g_variant_builder_init(&builder, G_VARIANT_TYPE(MTK_DBUS_SSAC_TYPE));
+    for (i = 0; i < MTK_SSAC_COUNT; i++) {
+        MtkSsacStatus status;
+
+        /* (factor, time, remaining, barred, held) */
+        mtk_ssac_status(ssac, i, &status);
+        g_variant_builder_add(&builder, "(uuuuu)", status.factor,
+            status.time, status.remaining, status.barred, status.held);
+    }
+    return g_variant_builder_end(&builder);
+}
+
+static
+void
+mtk_dbus_ssac_method_call(
+    GDBusConnection* connection,
+    const char* sender,
+    const char* path,
+    const char* iface,
+    const char* method,
+    GVariant* params,
+    GDBusMethodInvocation* call,
+    gpointer user_data)
+{
+    MtkDbus* self = user_data;
+
+    if (!g_strcmp0(method, "GetStatus")) {
+        g_dbus_method_invocation_return_value(call,
+            g_variant_new("(@" MTK_DBUS_SSAC_TYPE ")",
+            mtk_dbus_ssac_variant(self->ssac)));
+    } else {
+        g_dbus_method_invocation_return_error(call, G_DBUS_ERROR,
+            G_DBUS_ERROR_UNKNOWN_METHOD, "Unknown method %s", method);
+    }
+}
+
+static const GDBusInterfaceVTable mtk_dbus_ssac_vtable = {
+    mtk_dbus_ssac_method_call, NULL, NULL
+};
+
+static
+void
+mtk_dbus_ssac_changed(
+    MtkSsac* ssac,
+    void* user_data)
+{
+    MtkDbus* self = user_data;
+
+    if (self->ssac_reg_id) {
+        g_dbus_connection_emit_signal(mtk_dbus_service->connection, NULL,
+            self->path, MTK_DBUS_BARRING_INTERFACE, "StatusChanged",
+            g_variant_new("(@" MTK_DBUS_SSAC_TYPE ")",
+            mtk_dbus_ssac_variant(ssac)), NULL);
+    }
+}
+
+static
+GVariant*
+mtk_dbus_sip_event_variant(
+    const MtkSipLogEvent* event)
+{
+    /*
+     * (time, source, id, incoming, response, code, method, reason)
+     * The strings have been made valid UTF-8 by MtkSipLog.
+     */
+    return g_variant_new(MTK_DBUS_SIP_EVENT_TYPE, event->time, event->source,
+        event->id, event->incoming, event->response, event->code,
+        event->method, event->reason);
+}
+
+static
+void
+mtk_dbus_sip_log_method_call(
+    GDBusConnection* connection,
+    const char* sender,
+    const char* path,
+    const char* iface,
+    const char* method,
+    GVariant* params,
+    GDBusMethodInvocation* call,
+    gpointer user_data)
+{
+    MtkDbus* self = user_data;
+
+    if (!g_strcmp0(method, "GetEvents")) {
+        GVariantBuilder builder;
+        const guint n = mtk_sip_log_count(self->sip_log);
+        guint i;
+
+        g_variant_builder_init(&builder,
+            G_VARIANT_TYPE("a" MTK_DBUS_SIP_EVENT_TYPE));
+        for (i = 0; i < n; i++) {
+            g_variant_builder_add_value(&builder,
+                mtk_dbus_sip_event_variant(mtk_sip_log_get(self->sip_log,
+                i)));
+        }
+        g_dbus_method_invocation_return_value(call,
+            g_variant_new("(@a" MTK_DBUS_SIP_EVENT_TYPE ")",
+            g_variant_builder_end(&builder)));
+    } else {
+        g_dbus_method_invocation_return_error(call, G_DBUS_ERROR,
+            G_DBUS_ERROR_UNKNOWN_METHOD, "Unknown method %s", method);
+    }
+}
+
+static const GDBusInterfaceVTable mtk_dbus_sip_log_vtable = {
+    mtk_dbus_sip_log_method_call, NULL, NULL
+};
+
+static
+void
+mtk_dbus_sip_event_added(
+    const MtkSipLogEvent* event,
+    void* user_data)
+{
+    MtkDbus* self = user_data;
+
+    if (self->sip_log_reg_id) {
+        g_dbus_connection_emit_signal(mtk_dbus_service->connection, NULL,
+            self->path, MTK_DBUS_SIP_EVENTS_INTERFACE, "EventAdded",
+            g_variant_new("(@" MTK_DBUS_SIP_EVENT_TYPE ")",
+            mtk_dbus_sip_event_variant(event)), NULL);
+    }
+}
+
+static
+GVariant*
+mtk_dbus_latency_variant(
+    const MtkRadioExtLatency* latency)
+{
+    /* (count, last, max, total), all in microseconds */
+    return g_variant_new(MTK_DBUS_LATENCY_TYPE, latency->count,
+        latency->last, latency->max, latency->total);
+}
+
+static
+void
+mtk_dbus_add_code_count(
+    guint code,
+    guint count,
+    void* user_data)
+{
+    g_variant_builder_add((GVariantBuilder*)user_data, "(uu)", code, count);
+}
+
+static
+void
+mtk_dbus_radio_ext_method_call(
+    GDBusConnection* connection,
+    const char* sender,
+    const char* path,
+    const char* iface,
+    const char* method,
+    GVariant* params,
+    GDBusMethodInvocation* call,
+    gpointer user_data)
+{
+    MtkDbus* self = user_data;
+
+    if (!g_strcmp0(method, "GetAckStats")) {
+        const MtkRadioExtAckStats* stats =
+            mtk_radio_ext_ack_stats(self->radio_ext);
+
+        /* (expected, acked, unacked) */
+        g_dbus_method_invocation_return_value(call,
+            g_variant_new("(" MTK_DBUS_ACK_STATS_TYPE ")", stats->expected,
+            stats->acked, stats->unacked));
+    } else if (!g_strcmp0(method, "GetUnhandledIndications")) {
+        GVariantBuilder builder;
+
+        /* (code, count) of IMtkRadioExIndication codes nobody handles */
+        g_variant_builder_init(&builder, G_VARIANT_TYPE("a(uu)"));
+        mtk_radio_ext_foreach_unhandled_mtk_indication(self->radio_ext,
+            mtk_dbus_add_code_count, &builder);
+        g_dbus_method_invocation_return_value(call,
+            g_variant_new("(@a(uu))", g_variant_builder_end(&builder)));
+    } else if (!g_strcmp0(method, "GetIncomingCallLatency")) {
+        /* From the incomingCallIndication to it being allowed */
+        g_dbus_method_invocation_return_value(call,
+            g_variant_new("(@" MTK_DBUS_LATENCY_TYPE ")",
+            mtk_dbus_latency_variant(mtk_radio_ext_incoming_call_latency(
+            self->radio_ext))));
+    } else {
+        g_dbus_method_invocation_return_error(call, G_DBUS_ERROR,
+            G_DBUS_ERROR_UNKNOWN_METHOD, "Unknown method %s", method);
+    }
+}
+
+static const GDBusInterfaceVTable mtk_dbus_radio_ext_vtable = {
+    mtk_dbus_radio_ext_method_call, NULL, NULL
+};
+
+static
+GVariant*
+mtk_dbus_codec_variant(
+    guint call_id,
+    SpeechCodec codec)
+{
+    /* (call_id, codec, sample_rate) */
+    return g_variant_new(MTK_DBUS_CODEC_TYPE, call_id, codec,
+        mtk_radio_ext_speech_codec_sample_rate(codec));
+}
+
+static
+GVariant*
+mtk_dbus_rat_variant(
+    guint call_id,
+    const MtkImsCallRatStats* stats)
+{
+    gint64 ms[G_N_ELEMENTS(stats->time)];
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS(ms); i++) {
+        ms[i] = stats->time[i] / 1000;
+    }
+
+    /* (call_id, domain, rat, handovers, ms spent on each RAT) */
+    return g_variant_new("(uiiu@ax)", call_id, stats->domain, stats->rat,
+        stats->handovers, g_variant_new_fixed_array(G_VARIANT_TYPE_INT64,
+        ms, G_N_ELEMENTS(ms), sizeof(ms[0])));
+}
+
+/* The invocation is cleared once the reply has been sent */
+typedef struct mtk_dbus_call_request {
+    GDBusMethodInvocation* call;
+} MtkDbusCallRequest;
+
+static
+void
+mtk_dbus_call_request_complete(
+    BinderExtCall* ext,
+    BINDER_EXT_CALL_RESULT result,
+    void* user_data)
+{
+    MtkDbusCallRequest* req = user_data;
+
+    if (result == BINDER_EXT_CALL_RESULT_OK) {
+        g_dbus_method_invocation_return_value(req->call, NULL);
+    } else {
+        g_dbus_method_invocation_return_error_literal(req->call,
+            G_DBUS_ERROR, G_DBUS_ERROR_FAILED, "Request failed");
+    }
+    req->call = NULL;
+}
+
+static
+void
+mtk_dbus_call_request_destroy(
+    gpointer user_data)
+{
+    MtkDbusCallRequest* req = user_data;
+
+    if (req->call) {
+        g_dbus_method_invocation_return_error_literal(req->call,
+            G_DBUS_ERROR, G_DBUS_ERROR_FAILED, "Request cancelled");
+    }
+    g_slice_free(MtkDbusCallRequest, req);
+}
+
+static
+void
+mtk_dbus_ims_call_participant(
+    MtkDbus* self,
+    GVariant* params,
+    GDBusMethodInvocation* call,
+    gboolean add)
+{
+    MtkDbusCallRequest* req = g_slice_new(MtkDbusCallRequest);
+    const char* address = NULL;
+
+    /* Completed by mtk_dbus_call_request_complete */
+    req->call = call;
+    g_variant_get(params, "(&s)", &address);
+    if (!(add ? mtk_ims_call_add_participant : mtk_ims_call_remove_participant)
+        (self->ims_call, address, mtk_dbus_call_request_complete,
+        mtk_dbus_call_request_destroy, req)) {
+        /* The destroy callback isn't invoked on failure */
+        g_dbus_method_invocation_return_error(call, G_DBUS_ERROR,
+            G_DBUS_ERROR_FAILED, "Can't %s %s", add ? "add" : "remove",
+            address);
+        g_slice_free(MtkDbusCallRequest, req);
+    }
+}
+
+static
+void
+mtk_dbus_ims_call_method_call(
+    GDBusConnection* connection,
+    const char* sender,
+    const char* path,
+    const char* iface,
+    const char* method,
+    GVariant* params,
+    GDBusMethodInvocation* call,
+    gpointer user_data)
+{
+    MtkDbus* self = user_data;
+
+    if (!g_strcmp0(method, "GetSpeechCodecs")) {
+        const BinderExtCallInfo* const* calls =
+            binder_ext_call_get_calls(self->ims_call);
+        GVariantBuilder builder;
+
+        g_variant_builder_init(&builder,
+            G_VARIANT_TYPE("a" MTK_DBUS_CODEC_TYPE));
+        for (; calls && *calls; calls++) {
+            const guint call_id = (*calls)->call_id;
+
+            g_variant_builder_add_value(&builder,
+                mtk_dbus_codec_variant(call_id,
+                mtk_ims_call_speech_codec(self->ims_call, call_id)));
+        }
+        g_dbus_method_invocation_return_value(call,
+            g_variant_new("(@a" MTK_DBUS_CODEC_TYPE ")",
+            g_variant_builder_end(&builder)));
+    } else if (!g_strcmp0(method, "GetRats")) {
+        const BinderExtCallInfo* const* calls =
+            binder_ext_call_get_calls(self->ims_call);
+        GVariantBuilder builder;
+
+        g_variant_builder_init(&builder,
+            G_VARIANT_TYPE("a" MTK_DBUS_RAT_TYPE));
+        for (; calls && *calls; calls++) {
+            const guint call_id = (*calls)->call_id;
+            MtkImsCallRatStats stats;
+
+            if (mtk_ims_call_rat_stats(self->ims_call, call_id, &stats)) {
+                g_variant_builder_add_value(&builder,
+                    mtk_dbus_rat_variant(call_id, &stats));
+            }
+        }
+        g_dbus_method_invocation_return_value(call,
+            g_variant_new("(@a" MTK_DBUS_RAT_TYPE ")",
+            g_variant_builder_end(&builder)));
+    } else if (!g_strcmp0(method, "GetHandovers")) {
+        guint32 handovers[CALL_RAT_COUNT];
+        int i;
+
+        /* Indexed by CallRat, handovers to that RAT */
+        for (i = 0; i < CALL_RAT_COUNT; i++) {
+            handovers[i] = mtk_ims_call_handovers(self->ims_call, i);
+        }
+        g_dbus_method_invocation_return_value(call,
+            g_variant_new("(@au)", g_variant_new_fixed_array(
+            G_VARIANT_TYPE_UINT32, handovers, G_N_ELEMENTS(handovers),
+            sizeof(handovers[0]))));
+    } else if (!g_strcmp0(method, "GetAnswerLatency")) {
+        g_dbus_method_invocation_return_value(call,
+            g_variant_new("(@" MTK_DBUS_LATENCY_TYPE ")",
+            mtk_dbus_latency_variant(mtk_ims_call_answer_latency(
+            self->ims_call))));
+    } else if (!g_strcmp0(method, "GetHoldLatency")) {
+        g_dbus_method_invocation_return_value(call,
+            g_variant_new("(@" MTK_DBUS_LATENCY_TYPE ")",
+            mtk_dbus_latency_variant(mtk_ims_call_hold_latency(
+            self->ims_call))));
+    } else if (!g_strcmp0(method, "GetDialLatency")) {
+        GVariantBuilder builder;
+        int i;
+
+        /* Indexed by MTK_IMS_CALL_DIAL_PATH */
+        g_variant_builder_init(&builder,
+            G_VARIANT_TYPE("a" MTK_DBUS_LATENCY_TYPE));
+        for (i = 0; i < MTK_IMS_CALL_DIAL_PATH_COUNT; i++) {
+            g_variant_builder_add_value(&builder, mtk_dbus_latency_variant(
+                mtk_ims_call_dial_latency(self->ims_call, i)));
+        }
+        g_dbus_method_invocation_return_value(call,
+            g_variant_new("(@a" MTK_DBUS_LATENCY_TYPE ")",
+            g_variant_builder_end(&builder)));
+    } else if (!g_strcmp0(method, "AddParticipant")) {
+        mtk_dbus_ims_call_participant(self, params, call, TRUE);
+    } else if (!g_strcmp0(method, "RemoveParticipant")) {
+        mtk_dbus_ims_call_participant(self, params, call, FALSE);
+    } else {
+        g_dbus_method_invocation_return_error(call, G_DBUS_ERROR,
+            G_DBUS_ERROR_UNKNOWN_METHOD, "Unknown method %s", method);
+    }
+}
+
+static const GDBusInterfaceVTable mtk_dbus_ims_call_vtable = {
+    mtk_dbus_ims_call_method_call, NULL, NULL
+};
+
+static
+void
+mtk_dbus_speech_codec_changed(
+    BinderExtCall* ext,
+    SpeechCodec codec,
+    guint sample_rate,
+    void* user_data)
+{
+    MtkDbus* self = user_data;
+
+    if (self->ims_call_reg_id) {
+        const BinderExtCallInfo* const* calls = binder_ext_call_get_calls(ext);
+
+        /* The codec applies to all current calls */
+        for (; calls && *calls; calls++) {
+            g_dbus_connection_emit_signal(mtk_dbus_service->connection,
+                NULL, self->path, MTK_DBUS_CALLS_INTERFACE,
+                "SpeechCodecChanged", g_variant_new("(@" MTK_DBUS_CODEC_TYPE
+                ")", mtk_dbus_codec_variant((*calls)->call_id, codec)),
+                NULL);
+        }
+    }
+}
+
+static
+void
+mtk_dbus_rat_changed(
+    BinderExtCall* ext,
+    guint call_id,
+    const MtkImsCallRatStats* stats,
+    void* user_data)
+{
+    MtkDbus* self = user_data;
+
+    if (self->ims_call_reg_id) {
+        g_dbus_connection_emit_signal(mtk_dbus_service->connection, NULL,
+            self->path, MTK_DBUS_CALLS_INTERFACE, "RatChanged",
+            g_variant_new("(@" MTK_DBUS_RAT_TYPE ")",
+            mtk_dbus_rat_variant(call_id, stats)), NULL);
+    }
+}
+
+static
+void
+mtk_dbus_conf_participant_changed(
+    BinderExtCall* ext,
+    const MtkConfParticipant* participant,
+    gboolean removed,
+    void* user_data)
+{
+    MtkDbus* self = user_data;
+
+    if (self->ims_call_reg_id) {
+        /* (entity, display_text, status, removed) */
+        g_dbus_connection_emit_signal(mtk_dbus_service->connection, NULL,
+            self->path, MTK_DBUS_CALLS_INTERFACE, "ParticipantChanged",
+            g_variant_new("(" MTK_DBUS_PARTICIPANT_TYPE ")",
+            participant->entity, participant->display_text ?
+            participant->display_text : "", participant->status, removed),
+            NULL);
+    }
+}
+
+static
+guint
+mtk_dbus_register(
+    MtkDbus* self,
+    const char* name,
+    const GDBusInterfaceVTable* vtable)
+{
+    MtkDbusService* service = mtk_dbus_service;
+    GError* error = NULL;
+    guint id = g_dbus_connection_register_object(service->connection,
+        self->path, g_dbus_node_info_lookup_interface(service->node, name),
+        vtable, self, NULL, &error);
+
+    if (error) {
+        ofono_warn("Failed to export %s %s: %s", self->path, name,
+            error->message);
+        g_error_free(error);
+    }
+    return id;
+}
+
+static
+void
+mtk_dbus_unregister(
+    guint* id)
+{
+    if (*id) {
+        g_dbus_connection_unregister_object(mtk_dbus_service->connection,
+            *id);
+        *id = 0;
+    }
+}
+
+static
+void
+mtk_dbus_export(
+    MtkDbus* self)
+{
+    if (mtk_dbus_service->connection) {
+        if (self->cdr && !self->cdr_reg_id) {
+            self->cdr_reg_id = mtk_dbus_register(self,
+                MTK_DBUS_CALL_RECORDS_INTERFACE, &mtk_dbus_cdr_vtable);
+        }
+        if (self->ssac && !self->ssac_reg_id) {
+            self->ssac_reg_id = mtk_dbus_register(self,
+                MTK_DBUS_BARRING_INTERFACE, &mtk_dbus_ssac_vtable);
+        }
+        if (self->sip_log && !self->sip_log_reg_id) {
+            self->sip_log_reg_id = mtk_dbus_register(self,
+                MTK_DBUS_SIP_EVENTS_INTERFACE, &mtk_dbus_sip_log_vtable);
+        }
+        if (self->radio_ext && !self->radio_ext_reg_id) {
+            self->radio_ext_reg_id = mtk_dbus_register(self,
+                MTK_DBUS_RADIO_INTERFACE, &mtk_dbus_radio_ext_vtable);
+        }
+        if (self->ims_call && !self->ims_call_reg_id) {
+            self->ims_call_reg_id = mtk_dbus_register(self,
+                MTK_DBUS_CALLS_INTERFACE, &mtk_dbus_ims_call_vtable);
+        }
+    }
+}
+
+static
+void
+mtk_dbus_bus_acquired(
+    GDBusConnection* connection,
+    const char* name,
+    gpointer user_data)
+{
+    MtkDbusService* service = user_data;
+    GSList* l;
+
+    DBG("%s", name);
+    service->connection = g_object_ref(connection);
+    for (l = service->objects; l; l = l->next) {
+        mtk_dbus_export(l->data);
+    }
+}
+
+static
+void
+mtk_dbus_name_lost(
+    GDBusConnection* connection,
+    const char* name,
+    gpointer user_data)
+{
+    /* Objects remain reachable by the unique name */
+    ofono_warn("Failed to own D-Bus name %s", name);
+}
+
+static
+MtkDbusService*
+mtk_dbus_service_ref()
+{
+    MtkDbusService* service = mtk_dbus_service;
+
+    if (service) {
+        service->ref_count++;
+    } else {
+        service = g_new0(MtkDbusService, 1);
+        service->ref_count = 1;
+        service->node = g_dbus_node_info_new_for_xml(
+            mtk_dbus_introspection_xml, NULL);
+        mtk_dbus_service = service;
+        service->own_name_id = g_bus_own_name(G_BUS_TYPE_SYSTEM,
+            MTK_DBUS_SERVICE, G_BUS_NAME_OWNER_FLAGS_NONE,
+            mtk_dbus_bus_acquired, NULL, mtk_dbus_name_lost,
+            service, NULL);
+    }
+    return service;
+}
+
+static
+void
+mtk_dbus_service_unref(
+    MtkDbusService* service)
+{
+    if (!--(service->ref_count)) {
+        g_bus_unown_name(service->own_name_id);
+        if (service->connection) {
+            g_object_unref(service->connection);
+        }
+        g_dbus_node_info_unref(service->node);
+        g_free(service);
+        mtk_dbus_service = NULL;
+    }
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+MtkDbus*
+mtk_dbus_new(
+    const char* slot)
+{
+    MtkDbusService* service = mtk_dbus_service_ref();
+    MtkDbus* self = g_new0(MtkDbus, 1);
+
+    self->path = g_strconcat("/", slot, NULL);
+    service->objects = g_slist_append(service->objects, self);
+    return self;
+}
+
+void
+mtk_dbus_free(
+    MtkDbus* self)
+{
+    if (self) {
+        MtkDbusService* service = mtk_dbus_service;
+
+        mtk_dbus_set_cdr(self, NULL);
+        mtk_dbus_set_ssac(self, NULL);
+        mtk_dbus_set_sip_log(self, NULL);
+        mtk_dbus_set_radio_ext(self, NULL);
+        mtk_dbus_set_ims_call(self, NULL);
+        service->objects = g_slist_remove(service->objects, self);
+        mtk_dbus_service_unref(service);
+        g_free(self->path);
+        g_free(self);
+    }
+}
+
+void
+mtk_dbus_set_cdr(
+    MtkDbus* self,
+    MtkCdr* cdr)
+{
+    if (G_LIKELY(self) && self->cdr != cdr) {
+        if (self->cdr) {
+            mtk_cdr_set_record_func(self->cdr, NULL, NULL);
+            mtk_dbus_unregister(&self->cdr_reg_id);
+        }
+        self->cdr = cdr;
+        if (cdr) {
+            mtk_cdr_set_record_func(cdr, mtk_dbus_cdr_added, self);
+            mtk_dbus_export(self);
+        }
+    }
+}
+
+void
+mtk_dbus_set_ssac(
+    MtkDbus* self,
+    MtkSsac* ssac)
+{
+    if (G_LIKELY(self) && self->ssac != ssac) {
+        if (self->ssac) {
+            mtk_ssac_set_change_func(self->ssac, NULL, NULL);
+            mtk_dbus_unregister(&self->ssac_reg_id);
+        }
+        self->ssac = ssac;
+        if (ssac) {
+            mtk_ssac_set_change_func(ssac, mtk_dbus_ssac_changed, self);
+            mtk_dbus_export(self);
+        }
+    }
+}
+
+void
+mtk_dbus_set_sip_log(
+    MtkDbus* self,
+    MtkSipLog* sip_log)
+{
+    if (G_LIKELY(self) && self->sip_log != sip_log) {
+        if (self->sip_log) {
+            mtk_sip_log_set_event_func(self->sip_log, NULL, NULL);
+            mtk_dbus_unregister(&self->sip_log_reg_id);
+        }
+        self->sip_log = sip_log;
+        if (sip_log) {
+            mtk_sip_log_set_event_func(sip_log, mtk_dbus_sip_event_added,
+                self);
+            mtk_dbus_export(self);
+        }
+    }
+}
+
+void
+mtk_dbus_set_radio_ext(
+    MtkDbus* self,
+    MtkRadioExt* radio_ext)
+{
+    if (G_LIKELY(self) && self->radio_ext != radio_ext) {
+        if (self->radio_ext) {
+            mtk_dbus_unregister(&self->radio_ext_reg_id);
+        }
+        self->radio_ext = radio_ext;
+        if (radio_ext) {
+            mtk_dbus_export(self);
+        }
+    }
+}
+
+void
+mtk_dbus_set_ims_call(
+    MtkDbus* self,
+    BinderExtCall* ims_call)
+{
+    if (G_LIKELY(self) && self->ims_call != ims_call) {
+        if (self->ims_call) {
+            gutil_disconnect_handlers(self->ims_call,
+                self->ims_call_event_id,
+                G_N_ELEMENTS(self->ims_call_event_id));
+            mtk_dbus_unregister(&self->ims_call_reg_id);
+        }
+        self->ims_call = ims_call;
+        if (ims_call) {
+            self->ims_call_event_id[IMS_CALL_EVENT_SPEECH_CODEC] =
+                mtk_ims_call_add_speech_codec_handler(ims_call,
+                    mtk_dbus_speech_codec_changed, self);
+            self->ims_call_event_id[IMS_CALL_EVENT_RAT] =
+                mtk_ims_call_add_rat_handler(ims_call,
+                    mtk_dbus_rat_changed, self);
+            self->ims_call_event_id[IMS_CALL_EVENT_CONF_PARTICIPANT] =
+                mtk_ims_call_add_conf_participant_handler(ims_call,
+                    mtk_dbus_conf_participant_changed, self);
+            mtk_dbus_export(self);
+        }
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,85 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#ifndef MTK_DBUS_H
+#define MTK_DBUS_H
+
+#include <binder_ext_call.h>
+
+/*
+ * Diagnostics on the system bus. The service name is org.ofono.mtk,
+ * each slot is an object named after it, e.g. /imsSlot1
+ */
+
+typedef struct mtk_dbus MtkDbus;
+typedef struct mtk_cdr MtkCdr;
+typedef struct mtk_ssac MtkSsac;
+typedef struct mtk_sip_log MtkSipLog;
+typedef struct mtk_radio_ext MtkRadioExt;
+
+MtkDbus*
+mtk_dbus_new(
+    const char* slot)
+    G_GNUC_INTERNAL;
+
+void
+mtk_dbus_free(
+    MtkDbus* dbus)
+    G_GNUC_INTERNAL;
+
+/* Exports org.ofono.mtk.CallRecords, NULL removes it */
+void
+mtk_dbus_set_cdr(
+    MtkDbus* dbus,
+    MtkCdr* cdr)
+    G_GNUC_INTERNAL;
+
+/* Exports org.ofono.mtk.Barring, NULL removes it */
+void
+mtk_dbus_set_ssac(
+    MtkDbus* dbus,
+    MtkSsac* ssac)
+    G_GNUC_INTERNAL;
+
+/* Exports org.ofono.mtk.SipEvents, NULL removes it */
+void
+mtk_dbus_set_sip_log(
+    MtkDbus* dbus,
+    MtkSipLog* sip_log)
+    G_GNUC_INTERNAL;
+
+/* Exports org.ofono.mtk.Radio, NULL removes it */
+void
+mtk_dbus_set_radio_ext(
+    MtkDbus* dbus,
+    MtkRadioExt* radio_ext)
+    G_GNUC_INTERNAL;
+
+/* Exports org.ofono.mtk.Calls, NULL removes it */
+void
+mtk_dbus_set_ims_call(
+    MtkDbus* dbus,
+    BinderExtCall* ims_call)
+    G_GNUC_INTERNAL;
+
+#endif /* MTK_DBUS_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
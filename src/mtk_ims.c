@@ -40,6 +40,7 @@
 
 #include "mtk_ims.h"
 #include "mtk_ims_call.h"
+#include "mtk_ims_reg.h"
 #include "mtk_slot.h"
 #include "mtk_radio_ext.h"
 #include "mtk_radio_ext_types.h"
@@ -52,15 +53,26 @@
 #include <gbinder.h>
 
 #include <gutil_macros.h>
+#include <gutil_misc.h>
 
 #include <hybris/properties/properties.h>
 
+enum mtk_ims_radio_ext_events {
+    RADIO_EXT_EVENT_REG_STATUS,
+    RADIO_EXT_EVENT_REG_INFO,
+    RADIO_EXT_EVENT_REGISTRATION_INFO,
+    RADIO_EXT_EVENT_VOPS,
+    RADIO_EXT_EVENT_COUNT
+};
+
 typedef GObjectClass MtkImsClass;
 typedef struct mtk_ims {
     GObject parent;
     char* slot;
     MtkRadioExt* radio_ext;
-    BINDER_EXT_IMS_STATE ims_state;
+    MtkImsReg* reg;
+    gulong radio_ext_event_id[RADIO_EXT_EVENT_COUNT];
+    gboolean enable_deferred; /* setImsEnabled waits for VoPS */
     NMInfo nm_info;
     char ifname[32];
 } MtkIms;
@@ -170,9 +182,29 @@ mtk_ims_reg_status_changed(
         ims_state = BINDER_EXT_IMS_STATE_UNKNOWN;
     }
 
-    if (ims_state != self->ims_state) {
-        self->ims_state = ims_state;
-        g_signal_emit(self, mtk_ims_signals[SIGNAL_STATE_CHANGED], 0);
+    mtk_ims_reg_update(self->reg, MTK_IMS_REG_SOURCE_STATUS_REPORT,
+        ims_state);
+}
+
+static
+void
+mtk_ims_reg_info_changed(
+    MtkRadioExt* radio,
+    const MtkRadioExtImsRegInfo* info,
+    void* user_data)
+{
+    MtkIms* self = THIS(user_data);
+
+    /* Other reg_state values are transient, don't take them into account */
+    switch (info->reg_state) {
+    case 0:
+        mtk_ims_reg_update(self->reg, MTK_IMS_REG_SOURCE_REG_INFO,
+            BINDER_EXT_IMS_STATE_NOT_REGISTERED);
+        break;
+    case 1:
+        mtk_ims_reg_update(self->reg, MTK_IMS_REG_SOURCE_REG_INFO,
+            BINDER_EXT_IMS_STATE_REGISTERED);
+        break;
     }
 }
 
@@ -190,12 +222,47 @@ mtk_ims_registration_info_changed(
     ims_state = register_state ? BINDER_EXT_IMS_STATE_REGISTERED :
         BINDER_EXT_IMS_STATE_NOT_REGISTERED;
 
-    if (ims_state != self->ims_state) {
-        self->ims_state = ims_state;
-        g_signal_emit(self, mtk_ims_signals[SIGNAL_STATE_CHANGED], 0);
+    mtk_ims_reg_update(self->reg, MTK_IMS_REG_SOURCE_REGISTRATION_INFO,
+        ims_state);
+}
+
+static
+void
+mtk_ims_vops_changed(
+    MtkRadioExt* radio,
+    MTK_RADIO_EXT_VOPS vops,
+    void* user_data)
+{
+    MtkIms* self = THIS(user_data);
+
+    DBG("%s VoPS %d", self->slot, vops);
+    if (vops == MTK_RADIO_EXT_VOPS_SUPPORTED && self->enable_deferred) {
+        DBG("%s enabling IMS", self->slot);
+        self->enable_deferred = FALSE;
+        mtk_radio_ext_set_enabled(self->radio_ext, TRUE, NULL, NULL, NULL);
     }
 }
 
+static
+void
+mtk_ims_reg_state_changed(
+    MtkImsReg* reg,
+    BINDER_EXT_IMS_STATE state,
+    void* user_data)
+{
+    g_signal_emit(THIS(user_data), mtk_ims_signals[SIGNAL_STATE_CHANGED], 0);
+}
+
+static
+gboolean
+mtk_ims_wifi_connected(
+    MtkIms* self)
+{
+    /* Either NM has configured the interface or IMS is already on Wi-Fi */
+    return self->nm_info.ipv4_addr ||
+        mtk_radio_ext_ims_services(self->radio_ext, CALL_RAT_WIFI);
+}
+
 static
 void
 mtk_ims_nm_callback_wrapper(
@@ -215,6 +282,13 @@ mtk_ims_nm_callback_wrapper(
         dns_count,
         dns_servers,
         NULL, NULL, NULL);
+
+    /* VoWiFi doesn't need VoPS */
+    if (ipv4_addr && self->enable_deferred) {
+        DBG("%s Wi-Fi is up, enabling IMS", self->slot);
+        self->enable_deferred = FALSE;
+        mtk_radio_ext_set_enabled(self->radio_ext, TRUE, NULL, NULL, NULL);
+    }
 }
 
 /*==========================================================================*
@@ -227,9 +301,10 @@ mtk_ims_get_state(
     BinderExtIms* ext)
 {
     MtkIms* self = THIS(ext);
+    const BINDER_EXT_IMS_STATE ims_state = mtk_ims_reg_state(self->reg);
 
-    DBG("%s ims_state=%d", self->slot, self->ims_state);
-    return self->ims_state;
+    DBG("%s ims_state=%d", self->slot, ims_state);
+    return ims_state;
 }
 
 static
@@ -244,12 +319,20 @@ mtk_ims_set_registration(
     MtkIms* self = THIS(ext);
     const gboolean enabled = (registration != BINDER_EXT_IMS_REGISTRATION_OFF);
     gboolean have_wifi_interface;
+    MtkImsResultRequest* req;
+    guint id;
 
     DBG("%s, IMS registration: %d", self->slot, enabled);
 
+    if (!self->radio_ext) {
+        return 0;
+    }
+
     property_get("wifi.interface", self->ifname, ""); // seems to exist on mediateks, should be enough?
     have_wifi_interface = strcmp(self->ifname, "") != 0;
 
+    /* Decided again below, NM may report the address right away */
+    self->enable_deferred = FALSE;
     mtk_radio_ext_set_ims_cfg_feature_value(self->radio_ext,
         FEATURE_TYPE_VOICE_OVER_LTE, NETWORK_TYPE_LTE, enabled,
         have_wifi_interface ? ISLAST_FALSE : ISLAST_TRUE,
@@ -265,26 +348,54 @@ mtk_ims_set_registration(
             NULL, NULL, NULL);
 
         DBG("wifi interface is %s", self->ifname);
-        if (nm_initialize(&self->nm_info, self->ifname, mtk_ims_nm_callback_wrapper, self)) {
-            DBG("NM initialization successful for interface %s", self->ifname);
+        if (self->nm_info.iface_proxy) {
+            DBG("NM is already watching %s", self->ifname);
         } else {
-            DBG("NM initialization failed for interface %s", self->ifname);
+            nm_info_free(&self->nm_info);
+            if (nm_initialize(&self->nm_info, self->ifname, mtk_ims_nm_callback_wrapper, self)) {
+                DBG("NM initialization successful for interface %s", self->ifname);
+            } else {
+                DBG("NM initialization failed for interface %s", self->ifname);
+            }
         }
     }
 
-    MtkImsResultRequest* req = mtk_ims_result_request_new(ext,
-        complete, destroy, user_data);
-    guint id = mtk_radio_ext_set_enabled(self->radio_ext,
+    /*
+     * Registering over LTE is pointless if the cell doesn't support
+     * VoPS and Wi-Fi isn't connected. setImsEnabled then waits until
+     * either VoPS or a Wi-Fi connection shows up.
+     */
+    self->enable_deferred = enabled && !mtk_ims_wifi_connected(self) &&
+        mtk_radio_ext_vops(self->radio_ext) == MTK_RADIO_EXT_VOPS_NOT_SUPPORTED;
+
+    /*
+     * The destroy callback is only set once the request has been
+     * submitted, a failed submission frees the request but it's not
+     * supposed to invoke the callback.
+     */
+    req = mtk_ims_result_request_new(ext, complete, NULL, user_data);
+
+    if (self->enable_deferred) {
+        /* The request completes with a fresh VoPS query */
+        DBG("%s, no VoPS and no Wi-Fi, deferring IMS registration",
+            self->slot);
+        id = mtk_radio_ext_query_vops_status(self->radio_ext,
+            complete ? mtk_ims_result_request_complete : NULL,
+            mtk_ims_result_request_destroy, req);
+        if (id) {
+            req->destroy = destroy;
+        }
+        return id;
+    }
+
+    id = mtk_radio_ext_set_enabled(self->radio_ext,
         enabled,
         complete ? mtk_ims_result_request_complete : NULL,
         mtk_ims_result_request_destroy, req);
-
     if (id) {
-        return id;
-    } else {
-        mtk_ims_result_request_free(req);
-        return 0;
+        req->destroy = destroy;
     }
+    return id;
 }
 
 static
@@ -346,13 +457,24 @@ mtk_ims_new(
      */
     self->slot = g_strdup(slot);
     self->radio_ext = mtk_radio_ext_ref(radio_ext);
-    self->ims_state = BINDER_EXT_IMS_STATE_NOT_REGISTERED;
+    self->reg = mtk_ims_reg_new(slot, mtk_ims_reg_state_changed, self);
 
     if (self->radio_ext) {
-        mtk_radio_ext_add_ims_reg_status_handler(self->radio_ext,
-            mtk_ims_reg_status_changed, self);
-        mtk_radio_ext_add_ims_registration_info_handler(self->radio_ext,
-            mtk_ims_registration_info_changed, self);
+        self->radio_ext_event_id[RADIO_EXT_EVENT_REG_STATUS] =
+            mtk_radio_ext_add_ims_reg_status_handler(self->radio_ext,
+                mtk_ims_reg_status_changed, self);
+        self->radio_ext_event_id[RADIO_EXT_EVENT_REG_INFO] =
+            mtk_radio_ext_add_ims_reg_info_handler(self->radio_ext,
+                mtk_ims_reg_info_changed, self);
+        self->radio_ext_event_id[RADIO_EXT_EVENT_REGISTRATION_INFO] =
+            mtk_radio_ext_add_ims_registration_info_handler(self->radio_ext,
+                mtk_ims_registration_info_changed, self);
+        self->radio_ext_event_id[RADIO_EXT_EVENT_VOPS] =
+            mtk_radio_ext_add_vops_handler(self->radio_ext,
+                mtk_ims_vops_changed, self);
+
+        /* Don't wait for the next sendVopsIndication */
+        mtk_radio_ext_query_vops_status(self->radio_ext, NULL, NULL, NULL);
     }
 
     return BINDER_EXT_IMS(self);
@@ -369,6 +491,9 @@ mtk_ims_finalize(
 {
     MtkIms* self = THIS(object);
 
+    gutil_disconnect_handlers(self->radio_ext, self->radio_ext_event_id,
+        G_N_ELEMENTS(self->radio_ext_event_id));
+    mtk_ims_reg_free(self->reg);
     g_free(self->slot);
     mtk_radio_ext_unref(self->radio_ext);
     nm_info_free(&self->nm_info);
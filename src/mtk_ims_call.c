@@ -17,8 +17,11 @@
 #include <glib-object.h>
 
 #include "mtk_ims_call.h"
+#include "mtk_cdr.h"
+#include "mtk_conf_info.h"
 #include "mtk_radio_ext.h"
 #include "mtk_radio_ext_types.h"
+#include "mtk_ssac.h"
 #include "binder_util.h"
 
 #include <binder_ext_call_impl.h>
@@ -35,16 +38,70 @@
 #include <gutil_macros.h>
 #include <gutil_misc.h>
 
+#include <hybris/properties/properties.h>
+
+/* TS 24.008 Table 10.5.123 */
+#define MTK_IMS_CALL_CAUSE_NORMAL_CLEARING (16)
+#define MTK_IMS_CALL_CAUSE_USER_BUSY (17)
+#define MTK_IMS_CALL_CAUSE_NO_USER_RESPONDING (18)
+#define MTK_IMS_CALL_CAUSE_NO_ANSWER (19)
+#define MTK_IMS_CALL_CAUSE_CALL_REJECTED (21)
+#define MTK_IMS_CALL_CAUSE_NORMAL_UNSPECIFIED (31)
+
+enum mtk_ims_call_radio_ext_events {
+    RADIO_EXT_EVENT_CALL_INFO,
+    RADIO_EXT_EVENT_ECONF_RESULT,
+    RADIO_EXT_EVENT_EVENT_PACKAGE,
+    RADIO_EXT_EVENT_INCOMING_CALL,
+    RADIO_EXT_EVENT_CALL_RAT,
+    RADIO_EXT_EVENT_SPEECH_CODEC,
+    RADIO_EXT_EVENT_SSAC_STATUS,
+    RADIO_EXT_EVENT_COUNT
+};
+
 typedef GObjectClass MtkImsCallClass;
 typedef struct mtk_ims_call {
     GObject parent;
     GUtilIdlePool* pool;
     MtkRadioExt* radio_ext;
     RadioClient* ims_aosp_client;
-    GPtrArray* calls;
+    GPtrArray* calls; /* NULL-terminated MtkImsCallEntry pointers */
+    GHashTable* call_table; /* call_id => MtkImsCallEntry */
     GHashTable* id_map;
+    guint last_id;
+    guint calls_changed_id;
+    guint calls_changed_events;
+    guint calls_changed_signals;
+    MtkRadioExtLatency answer_latency;
+    MtkRadioExtLatency hold_latency;
+    MtkRadioExtLatency dial_latency[MTK_IMS_CALL_DIAL_PATH_COUNT];
+    guint handovers[CALL_RAT_COUNT]; /* By target RAT */
+    CallRatDomain rat_domain; /* Last reported, new calls start on it */
+    CallRat rat;
+    SpeechCodec codec; /* Last reported, same for new calls */
+    GQueue dial_queue; /* Dial refs waiting for a call id, NULL if cancelled */
+    GHashTable* zombies; /* Ids of cancelled dials, being hung up */
+    GQueue dtmf_queue; /* MtkImsCallResultRequest with tones */
+    RadioRequest* dtmf_req;
+    guint dtmf_pause_id;
+    char* dtmf_pause_chars;
+    guint dtmf_pause_ms;
+    MtkConfInfo* conf_info;
+    guint conf_call_id; /* Zero if there's no conference */
+    char* ecc_number; /* Non-NULL while the modem is in ECC mode */
+    guint ecc_call_id; /* Zero until the emergency dial gets a call id */
+    MtkCdr* cdr;
+    MtkSsac* ssac;
+    gulong radio_ext_event_id[RADIO_EXT_EVENT_COUNT];
 } MtkImsCall;
 
+#define MTK_IMS_CALL_DTMF_PAUSE_CHARS ",pP"
+#define MTK_IMS_CALL_DTMF_PAUSE_MS (3000)
+#define MTK_IMS_CALL_CDR_SIZE (32)
+#define MTK_IMS_CALL_SSAC_MAX_WAIT_MS (5000)
+#define MTK_IMS_CALL_ECC_LIST "112,911"
+#define MTK_IMS_CALL_ECC_LIST_PROP "ril.ecclist"
+
 static
 void
 mtk_ims_call_iface_init(
@@ -61,11 +118,50 @@ G_IMPLEMENT_INTERFACE(BINDER_EXT_TYPE_CALL, mtk_ims_call_iface_init))
 #define ID_KEY(id) GUINT_TO_POINTER(id)
 #define ID_VALUE(id) GUINT_TO_POINTER(id)
 
+/* BinderExtCallInfo must be the first member */
+typedef struct mtk_ims_call_entry {
+    BinderExtCallInfo info;
+    guint index; /* Position in MtkImsCall::calls */
+    gint64 answer_time; /* When answer was sent, zero if not pending */
+    gint64 hold_time; /* When hold was sent, zero if not pending */
+    gboolean hangup; /* Released from our side */
+    SpeechCodec codec;
+    MtkImsCallRatStats rat;
+    gint64 rat_since; /* When the current RAT was reported */
+} MtkImsCallEntry;
+
+/* mtk_ims_call.h can't see CALL_RAT_COUNT */
+G_STATIC_ASSERT(G_N_ELEMENTS(((MtkImsCallRatStats*)NULL)->time) ==
+    CALL_RAT_COUNT);
+
+typedef enum mtk_ims_call_action {
+    MTK_IMS_CALL_ACTION_ANSWER,
+    MTK_IMS_CALL_ACTION_HOLD,
+    MTK_IMS_CALL_ACTION_RESUME,
+    MTK_IMS_CALL_ACTION_HANGUP,
+    MTK_IMS_CALL_ACTION_MERGE
+} MTK_IMS_CALL_ACTION;
+
+typedef struct mtk_ims_call_step {
+    MTK_IMS_CALL_ACTION action;
+    guint call_id;
+} MtkImsCallStep;
+
 typedef struct mtk_ims_call_result_request {
     int ref_count;
-    guint id;
-    guint id_mapped;
+    guint id; /* MtkRadioExt request id */
+    guint id_mapped; /* Public id, key in MtkImsCall::id_map */
     guint param;
+    RadioRequest* radio_req; /* Pending IRadio request, not referenced */
+    GArray* steps; /* MtkImsCallStep, executed one by one */
+    guint next_step;
+    char* tones; /* DTMF string */
+    gsize tones_sent;
+    guint call_id; /* Assigned to a dial by MO_CALL_ID_ASSIGN */
+    char* address; /* Dial address */
+    MTK_IMS_CALL_DIAL_PATH dial_path;
+    gint64 dial_time;
+    guint ssac_id; /* Waiting for the barring to expire */
     BinderExtCall* ext;
     BinderExtCallResultFunc complete;
     GDestroyNotify destroy;
@@ -77,6 +173,9 @@ enum mtk_ims_call_signal {
     SIGNAL_CALL_DISCONNECTED,
     SIGNAL_CALL_RING,
     SIGNAL_CALL_SUPP_SVC_NOTIFY,
+    SIGNAL_CONF_PARTICIPANT,
+    SIGNAL_SPEECH_CODEC,
+    SIGNAL_CALL_RAT,
     SIGNAL_COUNT
 };
 
@@ -84,6 +183,9 @@ enum mtk_ims_call_signal {
 #define SIGNAL_CALL_DISCONNECTED_NAME     "mtk-ims-call-disconnected"
 #define SIGNAL_CALL_RING_NAME             "mtk-ims-call-ring"
 #define SIGNAL_CALL_SUPP_SVC_NOTIFY_NAME  "mtk-ims-call-supp-svc-notify"
+#define SIGNAL_CONF_PARTICIPANT_NAME      "mtk-ims-call-conf-participant"
+#define SIGNAL_SPEECH_CODEC_NAME          "mtk-ims-call-speech-codec"
+#define SIGNAL_CALL_RAT_NAME              "mtk-ims-call-rat"
 
 static guint mtk_ims_call_signals[SIGNAL_COUNT] = { 0 };
 
@@ -106,6 +208,15 @@ mtk_ims_call_result_request_new(
     return req;
 }
 
+static
+MtkImsCallResultRequest*
+mtk_ims_call_result_request_ref(
+    MtkImsCallResultRequest* req)
+{
+    req->ref_count++;
+    return req;
+}
+
 static
 void
 mtk_ims_call_result_request_free(
@@ -119,6 +230,11 @@ mtk_ims_call_result_request_free(
     if (req->id_mapped) {
         g_hash_table_remove(THIS(ext)->id_map, ID_KEY(req->id_mapped));
     }
+    if (req->steps) {
+        g_array_free(req->steps, TRUE);
+    }
+    g_free(req->tones);
+    g_free(req->address);
     binder_ext_call_unref(ext);
     gutil_slice_free(req);
 }
@@ -146,19 +262,55 @@ mtk_ims_call_result_request_destroy(
 
 static
 void
-mtk_ims_call_radio_request_complete(
-    RadioRequest* req,
-    RADIO_TX_STATUS status,
-    RADIO_RESP resp,
-    RADIO_ERROR error,
-    const GBinderReader* args,
-    gpointer user_data)
+mtk_ims_call_radio_ext_complete(
+    MtkRadioExt* radio,
+    int result,
+    void* user_data)
 {
-    MtkImsCallResultRequest* result_req = user_data;
+    MtkImsCallResultRequest* req = user_data;
 
-    if (result_req->complete) {
-        result_req->complete(result_req->ext, error ? BINDER_EXT_CALL_RESULT_ERROR :
-            BINDER_EXT_CALL_RESULT_OK, result_req->user_data);
+    if (req->complete) {
+        req->complete(req->ext, result ? BINDER_EXT_CALL_RESULT_ERROR :
+            BINDER_EXT_CALL_RESULT_OK, req->user_data);
+    }
+}
+
+/*
+ * Takes the result of a MtkRadioExt call which was passed a reference
+ * to the request and returns the public id which can be cancelled.
+ * Drops the caller's reference in any case.
+ */
+static
+guint
+mtk_ims_call_result_request_map(
+    MtkImsCall* self,
+    MtkImsCallResultRequest* req)
+{
+    do {
+        req->id_mapped = ++self->last_id;
+    } while (!req->id_mapped || g_hash_table_contains(self->id_map,
+        ID_KEY(req->id_mapped)));
+    g_hash_table_insert(self->id_map, ID_KEY(req->id_mapped), req);
+    return req->id_mapped;
+}
+
+static
+guint
+mtk_ims_call_result_request_submitted(
+    MtkImsCall* self,
+    MtkImsCallResultRequest* req,
+    guint id)
+{
+    if (id) {
+        req->id = id;
+        mtk_ims_call_result_request_map(self, req);
+        mtk_ims_call_result_request_unref(req);
+        return req->id_mapped;
+    } else {
+        /* MtkRadioExt has already dropped its reference */
+        req->destroy = NULL;
+        mtk_ims_call_result_request_unref(req);
+        return 0;
     }
 }
 
@@ -171,6 +323,8 @@ mtk_ims_call_msg_type_to_state(
     CallInfoMsgType msg_type)
 {
     switch (msg_type) {
+    case CALL_INFO_MSG_TYPE_MO_CALL_ID_ASSIGN:
+        return BINDER_EXT_CALL_STATE_DIALING;
     case CALL_INFO_MSG_TYPE_SETUP:
         return BINDER_EXT_CALL_STATE_INCOMING;
     case CALL_INFO_MSG_TYPE_ALERT:
@@ -193,29 +347,946 @@ mtk_ims_call_msg_type_to_state(
 }
 
 static
-BinderExtCallInfo*
-mtk_ims_call_info_new(
-    guint call_id,
-    guint call_mode,
-    char* number)
+MtkImsCallEntry*
+mtk_ims_call_entry_new(
+    MtkImsCall* self,
+    guint call_id,
+    guint call_mode,
+    char* number,
+    BINDER_EXT_CALL_FLAGS flags)
+{
+    const gsize number_len = strlen(number);
+    const gsize total = G_ALIGN8(sizeof(MtkImsCallEntry)) +
+        G_ALIGN8(number_len + 1);
+    MtkImsCallEntry* entry = g_malloc0(total);
+    BinderExtCallInfo* dest = &entry->info;
+    char* ptr = ((char*)entry) + G_ALIGN8(sizeof(MtkImsCallEntry));
+
+    dest->call_id = call_id;
+    dest->name = NULL;
+    dest->state = BINDER_EXT_CALL_STATE_INVALID;
+    dest->type = BINDER_EXT_CALL_TYPE_VOICE;
+    dest->flags = BINDER_EXT_CALL_FLAG_IMS | flags;
+
+    dest->number = ptr;
+    memcpy(ptr, number, number_len);
+    ptr += G_ALIGN8(number_len + 1);
+
+    /* The RAT is only reported when it changes */
+    entry->rat.domain = self->rat_domain;
+    entry->rat.rat = self->rat;
+    entry->rat_since = g_get_monotonic_time();
+    entry->codec = self->codec;
+    return entry;
+}
+
+static
+guint
+mtk_ims_call_table_size(
+    MtkImsCall* self)
+{
+    /* Not counting the NULL terminator */
+    return self->calls->len - 1;
+}
+
+static
+void
+mtk_ims_call_table_add(
+    MtkImsCall* self,
+    MtkImsCallEntry* entry)
+{
+    GPtrArray* calls = self->calls;
+
+    /* Replace the terminator and append a new one */
+    entry->index = calls->len - 1;
+    calls->pdata[entry->index] = entry;
+    g_ptr_array_add(calls, NULL);
+    g_hash_table_insert(self->call_table, ID_KEY(entry->info.call_id), entry);
+}
+
+static
+void
+mtk_ims_call_table_remove(
+    MtkImsCall* self,
+    MtkImsCallEntry* entry)
+{
+    GPtrArray* calls = self->calls;
+    const guint last = calls->len - 2;
+    MtkImsCallEntry* moved = calls->pdata[last];
+
+    /* Move the last entry into the hole and shrink */
+    calls->pdata[entry->index] = moved;
+    moved->index = entry->index;
+    calls->pdata[last] = NULL;
+    g_ptr_array_set_size(calls, last + 1);
+
+    /* This frees the entry */
+    g_hash_table_remove(self->call_table, ID_KEY(entry->info.call_id));
+}
+
+/*
+ * Dialing. Plain numbers go through IRadio dial() on the imsAosp
+ * client, SIP URIs are dialed by IMtkRadioEx directly and emergency
+ * numbers switch the modem to ECC mode first.
+ */
+
+static
+gboolean
+mtk_ims_call_is_emergency_number(
+    const char* number)
+{
+    char list[PROP_VALUE_MAX];
+    char** ecc;
+    char** ptr;
+    gboolean found = FALSE;
+
+    /* MTK RIL keeps "112,911" or "[112,0][911,0]" style lists there */
+    property_get(MTK_IMS_CALL_ECC_LIST_PROP, list, MTK_IMS_CALL_ECC_LIST);
+    if (strchr(list, '[')) {
+        /* [number,category] tuples, the category is not a number */
+        ecc = g_strsplit(list, "[", -1);
+        for (ptr = ecc; *ptr && !found; ptr++) {
+            char* end = strpbrk(*ptr, ",]");
+
+            if (end) {
+                *end = 0;
+            }
+            found = g_strstrip(*ptr)[0] && !strcmp(*ptr, number);
+        }
+    } else {
+        ecc = g_strsplit_set(list, ",;", -1);
+        for (ptr = ecc; *ptr && !found; ptr++) {
+            const char* entry = g_strstrip(*ptr);
+
+            found = entry[0] && !strcmp(entry, number);
+        }
+    }
+    g_strfreev(ecc);
+    if (!found && strcmp(list, MTK_IMS_CALL_ECC_LIST)) {
+        found = !strcmp(number, "112") || !strcmp(number, "911");
+    }
+    return found;
+}
+
+static
+MTK_IMS_CALL_DIAL_PATH
+mtk_ims_call_dial_path(
+    const char* number)
+{
+    if (!g_ascii_strncasecmp(number, "sip:", 4) ||
+        !g_ascii_strncasecmp(number, "sips:", 5) ||
+        strchr(number, '@')) {
+        return MTK_IMS_CALL_DIAL_PATH_SIP_URI;
+    } else if (mtk_ims_call_is_emergency_number(number)) {
+        return MTK_IMS_CALL_DIAL_PATH_EMERGENCY;
+    } else {
+        return MTK_IMS_CALL_DIAL_PATH_NORMAL;
+    }
+}
+
+static
+void
+mtk_ims_call_ecc_mode_off(
+    MtkImsCall* self)
+{
+    if (self->ecc_number) {
+        DBG("leaving ECC mode");
+        mtk_radio_ext_set_ecc_mode(self->radio_ext, self->ecc_number, FALSE,
+            FALSE, TRUE, NULL, NULL, NULL);
+        g_free(self->ecc_number);
+        self->ecc_number = NULL;
+    }
+    self->ecc_call_id = 0;
+}
+
+static
+void
+mtk_ims_call_dial_done(
+    MtkImsCallResultRequest* req,
+    gboolean ok)
+{
+    MtkImsCall* self = THIS(req->ext);
+
+    req->id = 0;
+    req->radio_req = NULL;
+
+    if (!ok) {
+        /* There won't be a call id to hang the record on */
+        mtk_cdr_dial_failed(self->cdr, req->dial_time);
+
+        /* The emergency call isn't going to happen */
+        if (req->dial_path == MTK_IMS_CALL_DIAL_PATH_EMERGENCY) {
+            mtk_ims_call_ecc_mode_off(self);
+        }
+
+        /* Nor will the modem assign it a call id */
+        if (g_queue_remove(&self->dial_queue, req)) {
+            mtk_ims_call_result_request_unref(req);
+        }
+    }
+
+    /*
+     * The modem handles dials one at a time, those cancelled before
+     * this one can no longer be assigned a call id.
+     */
+    while (g_queue_peek_head_link(&self->dial_queue) &&
+        !g_queue_peek_head(&self->dial_queue)) {
+        g_queue_pop_head(&self->dial_queue);
+    }
+
+    if (req->complete) {
+        req->complete(req->ext, ok ? BINDER_EXT_CALL_RESULT_OK :
+            BINDER_EXT_CALL_RESULT_ERROR, req->user_data);
+    }
+}
+
+static
+void
+mtk_ims_call_dial_radio_done(
+    RadioRequest* radio_req,
+    RADIO_TX_STATUS status,
+    RADIO_RESP resp,
+    RADIO_ERROR error,
+    const GBinderReader* args,
+    gpointer user_data)
+{
+    mtk_ims_call_dial_done(user_data, status == RADIO_TX_STATUS_OK &&
+        error == RADIO_ERROR_NONE);
+}
+
+static
+void
+mtk_ims_call_dial_ext_done(
+    MtkRadioExt* radio,
+    int result,
+    void* user_data)
+{
+    mtk_ims_call_dial_done(user_data, !result);
+}
+
+/* Adds the request to the dial queue on success */
+static
+gboolean
+mtk_ims_call_dial_submit(
+    MtkImsCall* self,
+    MtkImsCallResultRequest* result_req)
+{
+    /* Mostly duplicated from ofono-binder-plugin's binder_voicecall_dial */
+    GBinderParent parent;
+    RadioDial* dialInfo;
+    GBinderWriter writer;
+    RadioRequest* req;
+    gboolean ok;
+
+    /* dial(int32 serial, Dial dialInfo) */
+    req = radio_request_new(self->ims_aosp_client, RADIO_REQ_DIAL, &writer,
+        mtk_ims_call_dial_radio_done, mtk_ims_call_result_request_destroy,
+        mtk_ims_call_result_request_ref(result_req));
+
+    /* Prepare the Dial structure */
+    dialInfo = gbinder_writer_new0(&writer, RadioDial);
+    dialInfo->clir = result_req->param;
+    binder_copy_hidl_string(&writer, &dialInfo->address, result_req->address);
+
+    /* Write the parent structure */
+    parent.index = gbinder_writer_append_buffer_object(&writer, dialInfo,
+        sizeof(*dialInfo));
+
+    /* Write the string data */
+    binder_append_hidl_string_data(&writer, dialInfo, address, parent.index);
+
+    /* UUS information is empty but we still need to write a buffer */
+    parent.offset = G_STRUCT_OFFSET(RadioDial, uusInfo.data.ptr);
+    gbinder_writer_append_buffer_object_with_parent(&writer, NULL, 0, &parent);
+
+    /* Submit the request */
+    ok = radio_request_submit(req);
+    if (ok) {
+        result_req->radio_req = req;
+        g_queue_push_tail(&self->dial_queue,
+            mtk_ims_call_result_request_ref(result_req));
+    }
+    radio_request_unref(req);
+    return ok;
+}
+
+static
+void
+mtk_ims_call_ssac_done(
+    MtkSsac* ssac,
+    gboolean ok,
+    void* user_data)
+{
+    MtkImsCallResultRequest* req = user_data;
+    MtkImsCall* self = THIS(req->ext);
+
+    req->ssac_id = 0;
+    if (!ok) {
+        DBG("voice is still barred, not dialing %s", req->address);
+        mtk_ims_call_dial_done(req, FALSE);
+        return;
+    }
+
+    DBG("dialing %s", req->address);
+    req->dial_time = g_get_monotonic_time();
+    if (req->dial_path == MTK_IMS_CALL_DIAL_PATH_SIP_URI) {
+        req->id = mtk_radio_ext_dial_with_sip_uri(self->radio_ext,
+            req->address, mtk_ims_call_dial_ext_done,
+            mtk_ims_call_result_request_destroy,
+            mtk_ims_call_result_request_ref(req));
+        if (req->id) {
+            g_queue_push_tail(&self->dial_queue,
+                mtk_ims_call_result_request_ref(req));
+        }
+        ok = (req->id != 0);
+    } else {
+        ok = mtk_ims_call_dial_submit(self, req);
+    }
+    if (!ok) {
+        mtk_ims_call_dial_done(req, FALSE);
+    }
+}
+
+static
+void
+mtk_ims_call_ecc_mode_done(
+    MtkRadioExt* radio,
+    int result,
+    void* user_data)
+{
+    MtkImsCallResultRequest* req = user_data;
+
+    /* Dial anyway, the modem may still manage to place the call */
+    DBG("ECC mode %s", result ? "failed" : "set");
+    req->id = 0;
+    if (!mtk_ims_call_dial_submit(THIS(req->ext), req)) {
+        mtk_ims_call_dial_done(req, FALSE);
+    }
+}
+
+/*
+ * Multi-step operations (answer, swap) run their steps one at a time,
+ * each step is started when the previous one has completed successfully.
+ */
+
+static
+gboolean
+mtk_ims_call_chain_submit(
+    MtkImsCallResultRequest* req);
+
+static
+void
+mtk_ims_call_chain_step_done(
+    MtkImsCallResultRequest* req,
+    gboolean ok)
+{
+    req->id = 0;
+    req->radio_req = NULL;
+    if (ok && req->next_step < req->steps->len) {
+        if (mtk_ims_call_chain_submit(req)) {
+            return;
+        }
+        ok = FALSE;
+    }
+    if (req->complete) {
+        req->complete(req->ext, ok ? BINDER_EXT_CALL_RESULT_OK :
+            BINDER_EXT_CALL_RESULT_ERROR, req->user_data);
+    }
+}
+
+static
+void
+mtk_ims_call_chain_radio_ext_done(
+    MtkRadioExt* radio,
+    int result,
+    void* user_data)
+{
+    mtk_ims_call_chain_step_done(user_data, !result);
+}
+
+static
+void
+mtk_ims_call_chain_radio_done(
+    RadioRequest* radio_req,
+    RADIO_TX_STATUS status,
+    RADIO_RESP resp,
+    RADIO_ERROR error,
+    const GBinderReader* args,
+    gpointer user_data)
+{
+    mtk_ims_call_chain_step_done(user_data, status == RADIO_TX_STATUS_OK &&
+        error == RADIO_ERROR_NONE);
+}
+
+static
+gboolean
+mtk_ims_call_chain_submit(
+    MtkImsCallResultRequest* req)
+{
+    MtkImsCall* self = THIS(req->ext);
+    const MtkImsCallStep* step = &g_array_index(req->steps, MtkImsCallStep,
+        req->next_step++);
+    MtkImsCallEntry* entry = g_hash_table_lookup(self->call_table,
+        ID_KEY(step->call_id));
+    RadioRequest* radio_req;
+
+    switch (step->action) {
+    case MTK_IMS_CALL_ACTION_ANSWER:
+        /* acceptCall(int32 serial) */
+        radio_req = radio_request_new(self->ims_aosp_client,
+            RADIO_REQ_ACCEPT_CALL, NULL, mtk_ims_call_chain_radio_done,
+            mtk_ims_call_result_request_destroy,
+            mtk_ims_call_result_request_ref(req));
+        if (radio_request_submit(radio_req)) {
+            req->radio_req = radio_req;
+        }
+        radio_request_unref(radio_req);
+        if (req->radio_req && entry) {
+            entry->answer_time = g_get_monotonic_time();
+            mtk_cdr_event(self->cdr, step->call_id, MTK_CDR_EVENT_ANSWER,
+                entry->answer_time);
+        }
+        return req->radio_req != NULL;
+    case MTK_IMS_CALL_ACTION_HOLD:
+    case MTK_IMS_CALL_ACTION_RESUME:
+        req->id = mtk_radio_ext_control_call(self->radio_ext,
+            (step->action == MTK_IMS_CALL_ACTION_HOLD) ?
+            IMS_CONTROL_CALL_HOLD : IMS_CONTROL_CALL_RESUME, step->call_id,
+            mtk_ims_call_chain_radio_ext_done,
+            mtk_ims_call_result_request_destroy,
+            mtk_ims_call_result_request_ref(req));
+        if (req->id && entry && step->action == MTK_IMS_CALL_ACTION_HOLD) {
+            entry->hold_time = g_get_monotonic_time();
+        }
+        return req->id != 0;
+    case MTK_IMS_CALL_ACTION_HANGUP:
+        req->id = mtk_radio_ext_hangup_with_reason(self->radio_ext,
+            step->call_id, MTK_IMS_CALL_CAUSE_NORMAL_CLEARING,
+            mtk_ims_call_chain_radio_ext_done,
+            mtk_ims_call_result_request_destroy,
+            mtk_ims_call_result_request_ref(req));
+        if (req->id && entry) {
+            entry->hangup = TRUE;
+        }
+        return req->id != 0;
+    case MTK_IMS_CALL_ACTION_MERGE:
+        /* conference(int32 serial) */
+        radio_req = radio_request_new(self->ims_aosp_client,
+            RADIO_REQ_CONFERENCE, NULL, mtk_ims_call_chain_radio_done,
+            mtk_ims_call_result_request_destroy,
+            mtk_ims_call_result_request_ref(req));
+        if (radio_request_submit(radio_req)) {
+            req->radio_req = radio_req;
+        }
+        radio_request_unref(radio_req);
+        return req->radio_req != NULL;
+    }
+    return FALSE;
+}
+
+static
+void
+mtk_ims_call_chain_add(
+    MtkImsCallResultRequest* req,
+    MTK_IMS_CALL_ACTION action,
+    guint call_id)
+{
+    MtkImsCallStep step;
+
+    step.action = action;
+    step.call_id = call_id;
+    g_array_append_val(req->steps, step);
+}
+
+static
+void
+mtk_ims_call_chain_add_all(
+    MtkImsCall* self,
+    MtkImsCallResultRequest* req,
+    BINDER_EXT_CALL_STATE state,
+    MTK_IMS_CALL_ACTION action)
+{
+    guint i;
+
+    for (i = 0; i < mtk_ims_call_table_size(self); i++) {
+        const MtkImsCallEntry* entry = self->calls->pdata[i];
+
+        if (entry->info.state == state) {
+            mtk_ims_call_chain_add(req, action, entry->info.call_id);
+        }
+    }
+}
+
+static
+MtkImsCallResultRequest*
+mtk_ims_call_chain_new(
+    BinderExtCall* ext,
+    BinderExtCallResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data)
+{
+    MtkImsCallResultRequest* req = mtk_ims_call_result_request_new(ext,
+        complete, destroy, user_data);
+
+    req->steps = g_array_new(FALSE, FALSE, sizeof(MtkImsCallStep));
+    return req;
+}
+
+/* Drops the caller's reference, returns the public id or zero */
+static
+guint
+mtk_ims_call_chain_start(
+    MtkImsCall* self,
+    MtkImsCallResultRequest* req)
+{
+    if (req->steps->len && mtk_ims_call_chain_submit(req)) {
+        mtk_ims_call_result_request_map(self, req);
+        mtk_ims_call_result_request_unref(req);
+        return req->id_mapped;
+    } else {
+        req->destroy = NULL;
+        mtk_ims_call_result_request_unref(req);
+        return 0;
+    }
+}
+
+/*
+ * DTMF strings are queued and sent one sendDtmf request at a time,
+ * each request carrying all tones up to the next pause character.
+ * Completion is reported once per string.
+ */
+
+static
+void
+mtk_ims_call_dtmf_next(
+    MtkImsCall* self);
+
+static
+void
+mtk_ims_call_dtmf_finish(
+    MtkImsCall* self,
+    gboolean ok)
+{
+    MtkImsCallResultRequest* req = g_queue_pop_head(&self->dtmf_queue);
+
+    DBG("DTMF %s %s", req->tones, ok ? "sent" : "failed");
+    if (req->complete) {
+        req->complete(req->ext, ok ? BINDER_EXT_CALL_RESULT_OK :
+            BINDER_EXT_CALL_RESULT_ERROR, req->user_data);
+    }
+    mtk_ims_call_result_request_unref(req);
+}
+
+static
+void
+mtk_ims_call_dtmf_sent(
+    RadioRequest* radio_req,
+    RADIO_TX_STATUS status,
+    RADIO_RESP resp,
+    RADIO_ERROR error,
+    const GBinderReader* args,
+    gpointer user_data)
+{
+    MtkImsCall* self = THIS(user_data);
+
+    radio_request_unref(self->dtmf_req);
+    self->dtmf_req = NULL;
+    if (status != RADIO_TX_STATUS_OK || error != RADIO_ERROR_NONE) {
+        mtk_ims_call_dtmf_finish(self, FALSE);
+    }
+    mtk_ims_call_dtmf_next(self);
+}
+
+static
+gboolean
+mtk_ims_call_dtmf_pause_done(
+    gpointer user_data)
+{
+    MtkImsCall* self = THIS(user_data);
+
+    self->dtmf_pause_id = 0;
+    mtk_ims_call_dtmf_next(self);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+mtk_ims_call_dtmf_next(
+    MtkImsCall* self)
+{
+    const char* pause = self->dtmf_pause_chars;
+    MtkImsCallResultRequest* req;
+
+    while (!self->dtmf_req && !self->dtmf_pause_id &&
+        (req = g_queue_peek_head(&self->dtmf_queue)) != NULL) {
+        const char* tones = req->tones + req->tones_sent;
+        const gsize pauses = strspn(tones, pause);
+
+        if (pauses) {
+            req->tones_sent += pauses;
+            self->dtmf_pause_id = g_timeout_add(pauses * self->dtmf_pause_ms,
+                mtk_ims_call_dtmf_pause_done, self);
+        } else if (*tones) {
+            GBinderWriter writer;
+            char* str;
+
+            /* sendDtmf(int32 serial, string s) takes a single tone */
+            self->dtmf_req = radio_request_new(self->ims_aosp_client,
+                RADIO_REQ_SEND_DTMF, &writer, mtk_ims_call_dtmf_sent,
+                NULL, self);
+            str = gbinder_writer_memdup(&writer, tones, 2);
+            str[1] = 0;
+            gbinder_writer_append_hidl_string(&writer, str);
+            req->tones_sent++;
+            if (!radio_request_submit(self->dtmf_req)) {
+                radio_request_unref(self->dtmf_req);
+                self->dtmf_req = NULL;
+                mtk_ims_call_dtmf_finish(self, FALSE);
+            }
+        } else {
+            mtk_ims_call_dtmf_finish(self, TRUE);
+        }
+    }
+}
+
+static
+void
+mtk_ims_call_dtmf_stop(
+    MtkImsCall* self)
+{
+    if (self->dtmf_req) {
+        radio_request_drop(self->dtmf_req);
+        self->dtmf_req = NULL;
+    }
+    if (self->dtmf_pause_id) {
+        g_source_remove(self->dtmf_pause_id);
+        self->dtmf_pause_id = 0;
+    }
+}
+
+static
+void
+mtk_ims_call_dtmf_cancel(
+    MtkImsCall* self,
+    MtkImsCallResultRequest* req)
+{
+    if (g_queue_peek_head(&self->dtmf_queue) == req) {
+        mtk_ims_call_dtmf_stop(self);
+    }
+    g_queue_remove(&self->dtmf_queue, req);
+    mtk_ims_call_result_request_unref(req);
+    mtk_ims_call_dtmf_next(self);
+}
+
+static
+void
+mtk_ims_call_dtmf_flush(
+    MtkImsCall* self)
+{
+    /* No call to send tones to */
+    mtk_ims_call_dtmf_stop(self);
+    while (!g_queue_is_empty(&self->dtmf_queue)) {
+        mtk_ims_call_dtmf_finish(self, FALSE);
+    }
+}
+
+static
+void
+mtk_ims_call_emit_calls_changed(
+    MtkImsCall* self)
+{
+    self->calls_changed_signals++;
+    DBG("%u event(s), %u notification(s)", self->calls_changed_events,
+        self->calls_changed_signals);
+    g_signal_emit(self, mtk_ims_call_signals[SIGNAL_CALL_STATE_CHANGED], 0);
+}
+
+static
+gboolean
+mtk_ims_call_calls_changed_cb(
+    gpointer user_data)
+{
+    MtkImsCall* self = THIS(user_data);
+
+    self->calls_changed_id = 0;
+    mtk_ims_call_emit_calls_changed(self);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+mtk_ims_call_schedule_calls_changed(
+    MtkImsCall* self)
+{
+    /* Any number of changes results in one signal per idle dispatch */
+    self->calls_changed_events++;
+    if (!self->calls_changed_id) {
+        self->calls_changed_id = g_idle_add(mtk_ims_call_calls_changed_cb,
+            self);
+    }
+}
+
+static
+void
+mtk_ims_call_flush_calls_changed(
+    MtkImsCall* self)
+{
+    /* Deliver the pending change before an event that must follow it */
+    if (self->calls_changed_id) {
+        g_source_remove(self->calls_changed_id);
+        self->calls_changed_id = 0;
+        mtk_ims_call_emit_calls_changed(self);
+    }
+}
+
+static
+void
+mtk_ims_call_conf_participant_changed(
+    const MtkConfParticipant* participant,
+    gboolean removed,
+    void* user_data)
+{
+    MtkImsCall* self = THIS(user_data);
+
+    DBG("conference %u participant %s %s (%d)", self->conf_call_id,
+        participant->entity, removed ? "removed" : "updated",
+        participant->status);
+    g_signal_emit(self, mtk_ims_call_signals[SIGNAL_CONF_PARTICIPANT], 0,
+        participant, removed);
+}
+
+static
+void
+mtk_ims_call_conf_reset(
+    MtkImsCall* self)
+{
+    if (self->conf_call_id) {
+        DBG("conference %u is gone", self->conf_call_id);
+        self->conf_call_id = 0;
+        mtk_conf_info_clear(self->conf_info);
+    }
+}
+
+static
+void
+mtk_ims_call_handle_event_package(
+    MtkRadioExt* radio,
+    guint call_id,
+    guint type,
+    guint index,
+    guint count,
+    const char* data,
+    void* user_data)
+{
+    MtkImsCall* self = THIS(user_data);
+
+    if (type == IMS_EVENT_PACKAGE_CONFERENCE) {
+        if (self->conf_call_id != call_id) {
+            /* A different conference, start from scratch */
+            mtk_ims_call_conf_reset(self);
+            self->conf_call_id = call_id;
+        }
+
+        /*
+         * Large documents arrive in several pieces, the parser picks
+         * up where the previous piece has left off.
+         */
+        if (index <= 1) {
+            mtk_conf_info_begin(self->conf_info);
+        }
+        mtk_conf_info_feed(self->conf_info, data, strlen(data));
+        if (index >= count) {
+            DBG("conference %u has %u participant(s)", call_id,
+                mtk_conf_info_count(self->conf_info));
+        }
+    }
+}
+
+static
+void
+mtk_ims_call_handle_econf_result(
+    MtkRadioExt* radio,
+    guint conf_call_id,
+    guint op,
+    const char* number,
+    int result,
+    int cause,
+    guint joined_call_id,
+    void* user_data)
+{
+    /*
+     * Participant list is updated from the event package which
+     * follows, this is only the modem's verdict on the request.
+     */
+    DBG("conference %u %s %s %s, cause %d", conf_call_id,
+        (op == IMS_CONF_MEMBER_ADD) ? "add" : "remove", number,
+        result ? "failed" : "ok", cause);
+}
+
+static
+void
+mtk_ims_call_cdr_event(
+    MtkImsCall* self,
+    guint call_id,
+    CallInfoMsgType msg_type)
+{
+    switch (msg_type) {
+    case CALL_INFO_MSG_TYPE_SETUP:
+        mtk_cdr_event(self->cdr, call_id, MTK_CDR_EVENT_SETUP, 0);
+        mtk_cdr_set_incoming(self->cdr, call_id, TRUE);
+        break;
+    case CALL_INFO_MSG_TYPE_MO_CALL_ID_ASSIGN:
+        mtk_cdr_event(self->cdr, call_id, MTK_CDR_EVENT_ID_ASSIGNED, 0);
+        mtk_cdr_set_incoming(self->cdr, call_id, FALSE);
+        break;
+    case CALL_INFO_MSG_TYPE_ALERT:
+        mtk_cdr_event(self->cdr, call_id, MTK_CDR_EVENT_ALERTING, 0);
+        break;
+    case CALL_INFO_MSG_TYPE_CONNECTED:
+        mtk_cdr_event(self->cdr, call_id, MTK_CDR_EVENT_CONNECTED, 0);
+        break;
+    default:
+        break;
+    }
+}
+
+static
+void
+mtk_ims_call_handle_incoming_call(
+    MtkRadioExt* radio,
+    guint call_id,
+    gboolean allowed,
+    gint64 received,
+    void* user_data)
+{
+    MtkImsCall* self = THIS(user_data);
+
+    /* The event goes first, it may start a new timeline */
+    mtk_cdr_event(self->cdr, call_id, MTK_CDR_EVENT_INCOMING, received);
+    mtk_cdr_set_incoming(self->cdr, call_id, TRUE);
+    if (allowed) {
+        mtk_cdr_event(self->cdr, call_id, MTK_CDR_EVENT_ALLOWED, 0);
+    } else {
+        /* The modem won't tell us anything else about it */
+        mtk_cdr_disconnected(self->cdr, call_id, MTK_CDR_UNKNOWN);
+    }
+}
+
+static
+void
+mtk_ims_call_rat_update(
+    MtkImsCallEntry* entry,
+    gint64 now)
+{
+    MtkImsCallRatStats* stats = &entry->rat;
+
+    /* Account the time spent on the current RAT */
+    if (entry->rat_since) {
+        stats->time[stats->rat] += now - entry->rat_since;
+    }
+    entry->rat_since = now;
+}
+
+static
+void
+mtk_ims_call_handle_call_rat(
+    MtkRadioExt* radio,
+    CallRatDomain domain,
+    CallRat rat,
+    void* user_data)
+{
+    MtkImsCall* self = THIS(user_data);
+    const gint64 now = g_get_monotonic_time();
+    guint i;
+
+    /* Like the codec, the RAT applies to the current call(s) */
+    self->rat_domain = domain;
+    self->rat = rat;
+    for (i = 0; i < mtk_ims_call_table_size(self); i++) {
+        MtkImsCallEntry* entry = self->calls->pdata[i];
+        MtkImsCallRatStats* stats = &entry->rat;
+        const CallRat prev = stats->rat;
+
+        mtk_ims_call_rat_update(entry, now);
+        stats->domain = domain;
+        if (prev != rat) {
+            stats->rat = rat;
+            if (prev != CALL_RAT_UNKNOWN && rat != CALL_RAT_UNKNOWN) {
+                stats->handovers++;
+                self->handovers[rat]++;
+                DBG("call %u handed over to %s", entry->info.call_id,
+                    (rat == CALL_RAT_WIFI) ? "Wi-Fi" : "LTE");
+            }
+            g_signal_emit(self, mtk_ims_call_signals[SIGNAL_CALL_RAT], 0,
+                entry->info.call_id, stats);
+        }
+    }
+    mtk_cdr_set_rat(self->cdr, rat);
+}
+
+static
+void
+mtk_ims_call_handle_speech_codec(
+    MtkRadioExt* radio,
+    SpeechCodec codec,
+    void* user_data)
 {
-    const gsize number_len = strlen(number);
-    const gsize total = G_ALIGN8(sizeof(BinderExtCallInfo)) +
-        G_ALIGN8(number_len + 1);
-    BinderExtCallInfo* dest = g_malloc0(total);
-    char* ptr = ((char*)dest) + G_ALIGN8(sizeof(BinderExtCallInfo));
+    MtkImsCall* self = THIS(user_data);
+    guint i;
 
-    dest->call_id = call_id;
-    dest->name = NULL;
-    dest->state = BINDER_EXT_CALL_STATE_INVALID;
-    dest->type = BINDER_EXT_CALL_TYPE_VOICE;
-    dest->flags = BINDER_EXT_CALL_FLAG_IMS | BINDER_EXT_CALL_FLAG_INCOMING;
+    /*
+     * The codec isn't reported per call, it's what the modem has
+     * negotiated for the call(s) being set up or talking right now.
+     */
+    self->codec = codec;
+    for (i = 0; i < mtk_ims_call_table_size(self); i++) {
+        MtkImsCallEntry* entry = self->calls->pdata[i];
 
-    dest->number = ptr;
-    memcpy(ptr, number, number_len);
-    ptr += G_ALIGN8(number_len + 1);
+        entry->codec = codec;
+    }
+    mtk_cdr_set_codec(self->cdr, codec);
+
+    /* Emitted right away, audio may need it before CONNECTED */
+    g_signal_emit(self, mtk_ims_call_signals[SIGNAL_SPEECH_CODEC], 0,
+        codec, mtk_radio_ext_speech_codec_sample_rate(codec));
+}
+
+static
+void
+mtk_ims_call_handle_ssac_status(
+    MtkRadioExt* radio,
+    const MtkRadioExtSsacStatus* status,
+    void* user_data)
+{
+    MtkImsCall* self = THIS(user_data);
+
+    mtk_ssac_update(self->ssac, MTK_SSAC_VOICE, MAX(status->voice_factor, 0),
+        MAX(status->voice_time, 0));
+    mtk_ssac_update(self->ssac, MTK_SSAC_VIDEO, MAX(status->video_factor, 0),
+        MAX(status->video_time, 0));
+}
 
-    return dest;
+static
+BINDER_EXT_CALL_DISCONNECT_REASON
+mtk_ims_call_disconnect_reason(
+    const MtkImsCallEntry* entry,
+    int cause)
+{
+    if (entry && entry->hangup) {
+        return BINDER_EXT_CALL_DISCONNECT_LOCAL;
+    }
+    switch (cause) {
+    case MTK_IMS_CALL_CAUSE_NORMAL_CLEARING:
+    case MTK_IMS_CALL_CAUSE_USER_BUSY:
+    case MTK_IMS_CALL_CAUSE_NO_USER_RESPONDING:
+    case MTK_IMS_CALL_CAUSE_NO_ANSWER:
+    case MTK_IMS_CALL_CAUSE_CALL_REJECTED:
+    case MTK_IMS_CALL_CAUSE_NORMAL_UNSPECIFIED:
+        return BINDER_EXT_CALL_DISCONNECT_REMOTE;
+    }
+    /* Anything else is the network giving up on the call */
+    return (cause > 0) ? BINDER_EXT_CALL_DISCONNECT_ERROR :
+        BINDER_EXT_CALL_DISCONNECT_UNKNOWN;
 }
 
 static
@@ -226,10 +1297,11 @@ mtk_ims_call_handle_call_info(
     CallInfoMsgType msg_type,
     guint call_mode,
     char* number,
+    int cause,
     void* user_data)
 {
     MtkImsCall* self = THIS(user_data);
-    BinderExtCallInfo* call = NULL;
+    MtkImsCallEntry* entry;
     BINDER_EXT_CALL_STATE state = mtk_ims_call_msg_type_to_state(msg_type);
 
     if (state == BINDER_EXT_CALL_STATE_INVALID) {
@@ -237,28 +1309,111 @@ mtk_ims_call_handle_call_info(
         return;
     }
 
-    for (int i = 0; i < self->calls->len; i++) {
-        BinderExtCallInfo* info =
-            (BinderExtCallInfo*) g_ptr_array_index(self->calls, i);
-        if (info->call_id == call_id) {
-            call = info;
-            break;
+    entry = g_hash_table_lookup(self->call_table, ID_KEY(call_id));
+    mtk_ims_call_cdr_event(self, call_id, msg_type);
+    if (!entry && msg_type == CALL_INFO_MSG_TYPE_MO_CALL_ID_ASSIGN &&
+        !g_queue_is_empty(&self->dial_queue)) {
+        MtkImsCallResultRequest* dial = g_queue_pop_head(&self->dial_queue);
+
+        /* Dials are assigned ids in the order they were sent */
+        if (dial) {
+            MtkRadioExtLatency* latency = self->dial_latency + dial->dial_path;
+
+            mtk_cdr_event(self->cdr, call_id, MTK_CDR_EVENT_DIAL,
+                dial->dial_time);
+            mtk_radio_ext_latency_add(latency,
+                g_get_monotonic_time() - dial->dial_time);
+            DBG("dial to %s is call %u, %" G_GINT64_FORMAT " us",
+                number, call_id, latency->last);
+            dial->call_id = call_id;
+            if (dial->dial_path == MTK_IMS_CALL_DIAL_PATH_EMERGENCY) {
+                self->ecc_call_id = call_id;
+            }
+            mtk_ims_call_result_request_unref(dial);
+        } else {
+            /* Its dial has been cancelled in flight */
+            DBG("hanging up zombie call %u", call_id);
+            if (self->ecc_number && !self->ecc_call_id) {
+                /* Could be the emergency one, ECC mode ends with it */
+                self->ecc_call_id = call_id;
+            }
+            g_hash_table_add(self->zombies, ID_KEY(call_id));
+            mtk_radio_ext_hangup_with_reason(self->radio_ext, call_id,
+                MTK_IMS_CALL_CAUSE_NORMAL_CLEARING, NULL, NULL, NULL);
         }
     }
-    if (!call) {
-        call = mtk_ims_call_info_new(call_id, call_mode, number);
-        g_ptr_array_add(self->calls, call);
+
+    if (!entry && g_hash_table_contains(self->zombies, ID_KEY(call_id))) {
+        /* oFono has never seen this call and never will */
+        if (msg_type == CALL_INFO_MSG_TYPE_DISCONNECTED) {
+            DBG("zombie call %u is gone", call_id);
+            mtk_cdr_disconnected(self->cdr, call_id, cause);
+            g_hash_table_remove(self->zombies, ID_KEY(call_id));
+            if (call_id == self->ecc_call_id) {
+                mtk_ims_call_ecc_mode_off(self);
+            }
+        }
+        return;
     }
-    call->state = mtk_ims_call_msg_type_to_state(msg_type);
 
     if (msg_type == CALL_INFO_MSG_TYPE_DISCONNECTED) {
-        g_signal_emit(THIS(user_data),
-                      mtk_ims_call_signals[SIGNAL_CALL_DISCONNECTED], 0, call_id, "");
-        g_ptr_array_remove(self->calls, call);
+        mtk_cdr_disconnected(self->cdr, call_id, cause);
+        if (entry) {
+            const MtkImsCallRatStats* stats = &entry->rat;
+
+            mtk_ims_call_rat_update(entry, g_get_monotonic_time());
+            DBG("call %u: %u handover(s), LTE %" G_GINT64_FORMAT " ms, "
+                "Wi-Fi %" G_GINT64_FORMAT " ms", call_id, stats->handovers,
+                stats->time[CALL_RAT_LTE] / 1000,
+                stats->time[CALL_RAT_WIFI] / 1000);
+        }
+        mtk_ims_call_flush_calls_changed(self);
+        g_signal_emit(self, mtk_ims_call_signals[SIGNAL_CALL_DISCONNECTED],
+            0, call_id, mtk_ims_call_disconnect_reason(entry, cause));
+        if (entry) {
+            mtk_ims_call_table_remove(self, entry);
+        }
+        if (call_id == self->ecc_call_id) {
+            mtk_ims_call_ecc_mode_off(self);
+        }
+        if (call_id == self->conf_call_id) {
+            mtk_ims_call_conf_reset(self);
+        }
+        if (!mtk_ims_call_table_size(self)) {
+            mtk_ims_call_dtmf_flush(self);
+            mtk_ims_call_conf_reset(self);
+        }
+    } else {
+        if (!entry) {
+            /* Only SETUP starts an incoming call */
+            entry = mtk_ims_call_entry_new(self, call_id, call_mode, number,
+                (msg_type == CALL_INFO_MSG_TYPE_SETUP) ?
+                BINDER_EXT_CALL_FLAG_INCOMING : BINDER_EXT_CALL_FLAG_NONE);
+            mtk_ims_call_table_add(self, entry);
+        }
+        if (entry->answer_time && state == BINDER_EXT_CALL_STATE_ACTIVE) {
+            mtk_radio_ext_latency_add(&self->answer_latency,
+                g_get_monotonic_time() - entry->answer_time);
+            entry->answer_time = 0;
+            DBG("call %u answered in %" G_GINT64_FORMAT " us", call_id,
+                self->answer_latency.last);
+        }
+        if (entry->hold_time && state == BINDER_EXT_CALL_STATE_HOLDING) {
+            mtk_radio_ext_latency_add(&self->hold_latency,
+                g_get_monotonic_time() - entry->hold_time);
+            entry->hold_time = 0;
+            DBG("call %u held in %" G_GINT64_FORMAT " us", call_id,
+                self->hold_latency.last);
+        }
+        entry->info.state = state;
     }
 
-    g_signal_emit(THIS(user_data),
-                  mtk_ims_call_signals[SIGNAL_CALL_STATE_CHANGED], 0);
+    mtk_ims_call_schedule_calls_changed(self);
+    if (msg_type == CALL_INFO_MSG_TYPE_SETUP) {
+        /* The incoming call has to be known by the time it rings */
+        mtk_ims_call_flush_calls_changed(self);
+        g_signal_emit(self, mtk_ims_call_signals[SIGNAL_CALL_RING], 0);
+    }
 }
 
 /*==========================================================================*
@@ -270,10 +1425,8 @@ const BinderExtCallInfo* const*
 mtk_ims_call_get_calls(
     BinderExtCall* ext)
 {
-    static const BinderExtCallInfo* none = NULL;
-    MtkImsCall* self = THIS(ext);
-
-    return self->calls->len ? (const BinderExtCallInfo**)self->calls->pdata : &none;
+    /* Entries start with BinderExtCallInfo, the array is NULL-terminated */
+    return (const BinderExtCallInfo**)THIS(ext)->calls->pdata;
 }
 
 static
@@ -289,50 +1442,87 @@ mtk_ims_call_dial(
     void* user_data)
 {
     MtkImsCall* self = THIS(ext);
+    MtkImsCallResultRequest* req;
+    MTK_IMS_CALL_DIAL_PATH path;
+    guint id, barred_ms = 0;
 
-    /* Mostly duplicated from ofono-binder-plugin's binder_voicecall_dial */
-    // TODO: can we call back into ofono-binder-plugin with imsAospSlot instead?
-    GBinderParent parent;
-    RadioDial* dialInfo;
-    GBinderWriter writer;
-    RadioRequest* req;
-    MtkImsCallResultRequest* result_req = NULL;
-
-    result_req = mtk_ims_call_result_request_new(ext, complete, destroy,
-                                                 user_data);
-
-    /* dial(int32 serial, Dial dialInfo) */
-    req = radio_request_new(self->ims_aosp_client, RADIO_REQ_DIAL, &writer,
-        mtk_ims_call_radio_request_complete,
-        mtk_ims_call_result_request_destroy, result_req);
-
-    /* Prepare the Dial structure */
-    dialInfo = gbinder_writer_new0(&writer, RadioDial);
-    dialInfo->clir = clir;
-    binder_copy_hidl_string(&writer, &dialInfo->address, number);
-
-    /* Write the parent structure */
-    parent.index = gbinder_writer_append_buffer_object(&writer, dialInfo,
-        sizeof(*dialInfo));
+    if (!number || !number[0]) {
+        return 0;
+    }
 
-    /* Write the string data */
-    binder_append_hidl_string_data(&writer, dialInfo, address, parent.index);
+    /* Let the call go over CS right away if IMS can't carry it */
+    path = mtk_ims_call_dial_path(number);
+    if (path != MTK_IMS_CALL_DIAL_PATH_EMERGENCY &&
+        !mtk_radio_ext_ims_service_available(self->radio_ext,
+            MTK_RADIO_EXT_IMS_SERVICE_VOICE)) {
+        DBG("voice is not registered with IMS, not dialing %s", number);
+        return 0;
+    }
 
-    /* UUS information is empty but we still need to write a buffer */
-    parent.offset = G_STRUCT_OFFSET(RadioDial, uusInfo.data.ptr);
-    gbinder_writer_append_buffer_object_with_parent(&writer, NULL, 0, &parent);
+    /* SSAC doesn't apply to emergency calls */
+    if (path != MTK_IMS_CALL_DIAL_PATH_EMERGENCY) {
+        barred_ms = mtk_ssac_check(self->ssac, MTK_SSAC_VOICE);
+        if (barred_ms > MTK_IMS_CALL_SSAC_MAX_WAIT_MS) {
+            DBG("voice is barred for %u ms, not dialing %s", barred_ms,
+                number);
+            return 0;
+        }
+    }
 
-    // result_req = mtk_ims_call_result_request_new(ext, complete, destroy, user_data);
+    req = mtk_ims_call_result_request_new(ext, complete, destroy, user_data);
+    req->address = g_strdup(number);
+    req->param = clir;
+    req->dial_path = path;
+    req->dial_time = g_get_monotonic_time();
+
+    if (barred_ms) {
+        /* Short enough to wait for */
+        DBG("voice is barred, dialing %s in %u ms", number, barred_ms);
+        req->ssac_id = mtk_ssac_wait(self->ssac, MTK_SSAC_VOICE,
+            MTK_IMS_CALL_SSAC_MAX_WAIT_MS, mtk_ims_call_ssac_done,
+            mtk_ims_call_result_request_destroy,
+            mtk_ims_call_result_request_ref(req));
+        id = mtk_ims_call_result_request_map(self, req);
+        mtk_ims_call_result_request_unref(req);
+        return id;
+    }
 
-    /* Submit the request */
-    if (radio_request_submit(req)) {
-        radio_request_unref(req);
-        return 1; /* not the actual serial, but return something non-null */
-    } else {
-        mtk_ims_call_result_request_unref(result_req);
-        radio_request_unref(req);
-        return 0;
+    switch (req->dial_path) {
+    case MTK_IMS_CALL_DIAL_PATH_SIP_URI:
+        /* One hop, straight to the IMS stack */
+        DBG("dialing %s with SIP URI", number);
+        id = mtk_radio_ext_dial_with_sip_uri(self->radio_ext, number,
+            mtk_ims_call_dial_ext_done, mtk_ims_call_result_request_destroy,
+            mtk_ims_call_result_request_ref(req));
+        if (id) {
+            g_queue_push_tail(&self->dial_queue,
+                mtk_ims_call_result_request_ref(req));
+        }
+        return mtk_ims_call_result_request_submitted(self, req, id);
+    case MTK_IMS_CALL_DIAL_PATH_EMERGENCY:
+        /* The modem has to be in emergency mode before dialing */
+        DBG("dialing emergency number %s", number);
+        id = mtk_radio_ext_set_ecc_mode(self->radio_ext, number, TRUE,
+            FALSE, TRUE, mtk_ims_call_ecc_mode_done,
+            mtk_ims_call_result_request_destroy,
+            mtk_ims_call_result_request_ref(req));
+        if (id) {
+            /* Left when the call ends or the dial fails */
+            g_free(self->ecc_number);
+            self->ecc_number = g_strdup(number);
+            self->ecc_call_id = 0;
+        }
+        return mtk_ims_call_result_request_submitted(self, req, id);
+    case MTK_IMS_CALL_DIAL_PATH_NORMAL:
+    case MTK_IMS_CALL_DIAL_PATH_COUNT:
+        break;
     }
+
+    DBG("dialing %s", number);
+    id = mtk_ims_call_dial_submit(self, req) ?
+        mtk_ims_call_result_request_map(self, req) : 0;
+    mtk_ims_call_result_request_unref(req);
+    return id;
 }
 
 static
@@ -344,8 +1534,31 @@ mtk_ims_call_answer(
     GDestroyNotify destroy,
     void* user_data)
 {
-    DBG("answer is not implemented yet");
-    return 0;
+    MtkImsCall* self = THIS(ext);
+    MtkImsCallResultRequest* req = mtk_ims_call_chain_new(ext,
+        complete, destroy, user_data);
+    const MtkImsCallEntry* incoming = NULL;
+    guint i;
+
+    for (i = 0; i < mtk_ims_call_table_size(self) && !incoming; i++) {
+        const MtkImsCallEntry* entry = self->calls->pdata[i];
+
+        if (entry->info.state == BINDER_EXT_CALL_STATE_INCOMING) {
+            incoming = entry;
+        }
+    }
+
+    if (incoming) {
+        /* Active calls have to be put on hold first */
+        DBG("answering call %u", incoming->info.call_id);
+        mtk_ims_call_chain_add_all(self, req, BINDER_EXT_CALL_STATE_ACTIVE,
+            MTK_IMS_CALL_ACTION_HOLD);
+        mtk_ims_call_chain_add(req, MTK_IMS_CALL_ACTION_ANSWER,
+            incoming->info.call_id);
+    } else {
+        DBG("no call to answer");
+    }
+    return mtk_ims_call_chain_start(self, req);
 }
 
 static
@@ -358,8 +1571,47 @@ mtk_ims_call_swap(
     GDestroyNotify destroy,
     void* user_data)
 {
-    DBG("swap is not implemented yet");
-    return 0;
+    MtkImsCall* self = THIS(ext);
+    MtkImsCallResultRequest* req = mtk_ims_call_chain_new(ext,
+        complete, destroy, user_data);
+    guint i, incoming = 0;
+
+    for (i = 0; i < mtk_ims_call_table_size(self) && !incoming; i++) {
+        const MtkImsCallEntry* entry = self->calls->pdata[i];
+
+        if (entry->info.state == BINDER_EXT_CALL_STATE_INCOMING) {
+            incoming = entry->info.call_id;
+        }
+    }
+
+    /* Release or hold the active calls, then resume or answer */
+    mtk_ims_call_chain_add_all(self, req, BINDER_EXT_CALL_STATE_ACTIVE,
+        (swap_flags & BINDER_EXT_CALL_SWAP_FLAG_HANGUP) ?
+        MTK_IMS_CALL_ACTION_HANGUP : MTK_IMS_CALL_ACTION_HOLD);
+    if (incoming) {
+        mtk_ims_call_chain_add(req, MTK_IMS_CALL_ACTION_ANSWER, incoming);
+    } else {
+        mtk_ims_call_chain_add_all(self, req, BINDER_EXT_CALL_STATE_HOLDING,
+            MTK_IMS_CALL_ACTION_RESUME);
+    }
+    DBG("%u step(s)", req->steps->len);
+    return mtk_ims_call_chain_start(self, req);
+}
+
+static
+int
+mtk_ims_call_hangup_cause(
+    BINDER_EXT_CALL_HANGUP_REASON reason)
+{
+    switch (reason) {
+    case BINDER_EXT_CALL_HANGUP_REJECT:
+        return MTK_IMS_CALL_CAUSE_USER_BUSY;
+    case BINDER_EXT_CALL_HANGUP_IGNORE:
+        return MTK_IMS_CALL_CAUSE_CALL_REJECTED;
+    case BINDER_EXT_CALL_HANGUP_TERMINATE:
+        break;
+    }
+    return MTK_IMS_CALL_CAUSE_NORMAL_CLEARING;
 }
 
 static
@@ -374,10 +1626,35 @@ mtk_ims_call_hangup(
     void* user_data)
 {
     MtkImsCall* self = THIS(ext);
-    mtk_radio_ext_hangup_all(self->radio_ext,
-        NULL, NULL, NULL);
+    MtkImsCallResultRequest* req = mtk_ims_call_result_request_new(ext,
+        complete, destroy, user_data);
+    guint i, id;
+
+    for (i = 0; i < mtk_ims_call_table_size(self); i++) {
+        MtkImsCallEntry* entry = self->calls->pdata[i];
 
-    return 0;
+        if (!call_id || entry->info.call_id == call_id) {
+            entry->hangup = TRUE;
+        }
+    }
+
+    if (call_id) {
+        /* Only release this call, leaving the others alone */
+        DBG("hanging up call %u, reason %d", call_id, reason);
+        id = mtk_radio_ext_hangup_with_reason(self->radio_ext, call_id,
+            mtk_ims_call_hangup_cause(reason),
+            mtk_ims_call_radio_ext_complete,
+            mtk_ims_call_result_request_destroy,
+            mtk_ims_call_result_request_ref(req));
+    } else {
+        /* Zero call id means all calls */
+        DBG("hanging up all calls");
+        id = mtk_radio_ext_hangup_all(self->radio_ext,
+            mtk_ims_call_radio_ext_complete,
+            mtk_ims_call_result_request_destroy,
+            mtk_ims_call_result_request_ref(req));
+    }
+    return mtk_ims_call_result_request_submitted(self, req, id);
 }
 
 static
@@ -389,8 +1666,34 @@ mtk_ims_call_conference(
     GDestroyNotify destroy,
     void* user_data)
 {
-    DBG("conference is not implemented yet");
-    return 0;
+    MtkImsCall* self = THIS(ext);
+    MtkImsCallResultRequest* req = mtk_ims_call_chain_new(ext,
+        complete, destroy, user_data);
+    guint i, active = 0, held = 0;
+
+    for (i = 0; i < mtk_ims_call_table_size(self); i++) {
+        const MtkImsCallEntry* entry = self->calls->pdata[i];
+
+        switch (entry->info.state) {
+        case BINDER_EXT_CALL_STATE_ACTIVE:
+            active++;
+            break;
+        case BINDER_EXT_CALL_STATE_HOLDING:
+            held++;
+            break;
+        default:
+            break;
+        }
+    }
+
+    /* Merging needs both an active and a held call */
+    if (active && held) {
+        DBG("merging %u active and %u held call(s)", active, held);
+        mtk_ims_call_chain_add(req, MTK_IMS_CALL_ACTION_MERGE, 0);
+    } else {
+        DBG("nothing to merge");
+    }
+    return mtk_ims_call_chain_start(self, req);
 }
 
 static
@@ -402,8 +1705,85 @@ mtk_ims_call_send_dtmf(
     GDestroyNotify destroy,
     void* user_data)
 {
-    DBG("send_dtmf is not implemented yet");
-    return 0;
+    MtkImsCall* self = THIS(ext);
+    MtkImsCallResultRequest* req;
+
+    if (!tones || !tones[0] || !mtk_ims_call_table_size(self)) {
+        return 0;
+    }
+
+    req = mtk_ims_call_result_request_new(ext, complete, destroy, user_data);
+    req->tones = g_strdup(tones);
+    g_queue_push_tail(&self->dtmf_queue, req);
+    mtk_ims_call_result_request_map(self, req);
+    mtk_ims_call_dtmf_next(self);
+    return req->id_mapped;
+}
+
+static
+void
+mtk_ims_call_dial_cancel(
+    MtkImsCall* self,
+    MtkImsCallResultRequest* req)
+{
+    RadioRequest* radio_req = req->radio_req;
+
+    if (req->ssac_id) {
+        const guint ssac_id = req->ssac_id;
+
+        /* This drops the last reference and removes the mapping */
+        DBG("cancelling barred dial");
+        req->ssac_id = 0;
+        mtk_ssac_cancel(self->ssac, ssac_id);
+        return;
+    }
+
+    /* Dropping the queue's reference may leave the caller's the last one */
+    mtk_ims_call_result_request_ref(req);
+    if (req->call_id) {
+        const guint call_id = req->call_id;
+        MtkImsCallEntry* entry = g_hash_table_lookup(self->call_table,
+            ID_KEY(call_id));
+
+        /* The dial has got as far as a call, release it right away */
+        DBG("cancelling dial, hanging up call %u", call_id);
+        req->call_id = 0;
+        if (entry) {
+            entry->hangup = TRUE;
+        }
+        mtk_radio_ext_hangup_with_reason(self->radio_ext, call_id,
+            MTK_IMS_CALL_CAUSE_NORMAL_CLEARING, NULL, NULL, NULL);
+    } else if (req->id || !radio_req ||
+        radio_req->state == RADIO_REQUEST_STATE_PENDING) {
+        GList* link = g_queue_find(&self->dial_queue, req);
+
+        /*
+         * The modem already has it (or has even completed it) and may
+         * still assign it a call id. Keep its place in the queue so that
+         * call gets hung up.
+         */
+        DBG("cancelling dial in flight");
+        link->data = NULL;
+        mtk_ims_call_result_request_unref(req);
+    } else {
+        /* Not transmitted yet, the modem will never see it */
+        DBG("cancelling dial");
+        if (g_queue_remove(&self->dial_queue, req)) {
+            mtk_ims_call_result_request_unref(req);
+        }
+        if (req->dial_path == MTK_IMS_CALL_DIAL_PATH_EMERGENCY) {
+            mtk_ims_call_ecc_mode_off(self);
+        }
+    }
+
+    /* Then dropping ours removes the mapping */
+    if (radio_req) {
+        req->radio_req = NULL;
+        radio_request_cancel(radio_req);
+    } else if (req->id) {
+        mtk_radio_ext_cancel(self->radio_ext, req->id);
+    }
+    mtk_ims_call_result_request_unref(req);
 }
 
 static
@@ -413,10 +1793,32 @@ mtk_ims_call_cancel(
     guint id)
 {
     MtkImsCall* self = THIS(ext);
-    const guint mapped = GPOINTER_TO_UINT(g_hash_table_lookup(self->id_map,
-        ID_KEY(id)));
-
-    mtk_radio_ext_cancel(self->radio_ext, mapped ? mapped : id);
+    MtkImsCallResultRequest* req = g_hash_table_lookup(self->id_map,
+        ID_KEY(id));
+
+    if (req) {
+        /* This drops the last reference and removes the mapping */
+        if (req->tones) {
+            mtk_ims_call_dtmf_cancel(self, req);
+        } else if (g_queue_find(&self->dial_queue, req) || req->call_id ||
+            req->ssac_id) {
+            mtk_ims_call_dial_cancel(self, req);
+        } else if (req->radio_req) {
+            RadioRequest* radio_req = req->radio_req;
+
+            req->radio_req = NULL;
+            radio_request_cancel(radio_req);
+        } else if (req->id) {
+            const gboolean ecc = (req->dial_path ==
+                MTK_IMS_CALL_DIAL_PATH_EMERGENCY);
+
+            /* An emergency dial still waiting for setEccMode */
+            mtk_radio_ext_cancel(self->radio_ext, req->id);
+            if (ecc) {
+                mtk_ims_call_ecc_mode_off(self);
+            }
+        }
+    }
 }
 
 static
@@ -499,16 +1901,220 @@ mtk_ims_call_new(
 
         self->radio_ext = mtk_radio_ext_ref(radio_ext);
         self->ims_aosp_client = radio_client_ref(ims_aosp_client);
-        self->calls = g_ptr_array_new_with_free_func(g_free);
 
-        mtk_radio_ext_add_call_info_handler(radio_ext,
+        self->radio_ext_event_id[RADIO_EXT_EVENT_CALL_INFO] =
+            mtk_radio_ext_add_call_info_handler(radio_ext,
                 mtk_ims_call_handle_call_info, self);
+        self->radio_ext_event_id[RADIO_EXT_EVENT_ECONF_RESULT] =
+            mtk_radio_ext_add_econf_result_handler(radio_ext,
+                mtk_ims_call_handle_econf_result, self);
+        self->radio_ext_event_id[RADIO_EXT_EVENT_EVENT_PACKAGE] =
+            mtk_radio_ext_add_event_package_handler(radio_ext,
+                mtk_ims_call_handle_event_package, self);
+        self->radio_ext_event_id[RADIO_EXT_EVENT_INCOMING_CALL] =
+            mtk_radio_ext_add_incoming_call_handler(radio_ext,
+                mtk_ims_call_handle_incoming_call, self);
+        self->radio_ext_event_id[RADIO_EXT_EVENT_CALL_RAT] =
+            mtk_radio_ext_add_call_rat_handler(radio_ext,
+                mtk_ims_call_handle_call_rat, self);
+        self->radio_ext_event_id[RADIO_EXT_EVENT_SPEECH_CODEC] =
+            mtk_radio_ext_add_speech_codec_handler(radio_ext,
+                mtk_ims_call_handle_speech_codec, self);
+        self->radio_ext_event_id[RADIO_EXT_EVENT_SSAC_STATUS] =
+            mtk_radio_ext_add_ssac_status_handler(radio_ext,
+                mtk_ims_call_handle_ssac_status, self);
+
+        /* The barring may already be in effect */
+        mtk_radio_ext_query_ssac_status(radio_ext, NULL, NULL, NULL);
 
         return BINDER_EXT_CALL(self);
     }
     return NULL;
 }
 
+guint
+mtk_ims_call_count(
+    BinderExtCall* ext)
+{
+    return G_LIKELY(ext) ? mtk_ims_call_table_size(THIS(ext)) : 0;
+}
+
+static
+guint
+mtk_ims_call_control_participant(
+    BinderExtCall* ext,
+    ImsConfMemberOp op,
+    const char* address,
+    BinderExtCallResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data)
+{
+    MtkImsCall* self = THIS(ext);
+    MtkImsCallResultRequest* req;
+
+    if (!self->conf_call_id || !address || !address[0]) {
+        DBG("no conference or no address");
+        return 0;
+    }
+
+    DBG("%s %s, conference %u", (op == IMS_CONF_MEMBER_ADD) ?
+        "adding" : "removing", address, self->conf_call_id);
+    req = mtk_ims_call_result_request_new(ext, complete, destroy, user_data);
+    return mtk_ims_call_result_request_submitted(self, req,
+        mtk_radio_ext_control_conference_member(self->radio_ext, op,
+            self->conf_call_id, address, -1, mtk_ims_call_radio_ext_complete,
+            mtk_ims_call_result_request_destroy,
+            mtk_ims_call_result_request_ref(req)));
+}
+
+guint
+mtk_ims_call_add_participant(
+    BinderExtCall* ext,
+    const char* address,
+    BinderExtCallResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data)
+{
+    return G_LIKELY(ext) ? mtk_ims_call_control_participant(ext,
+        IMS_CONF_MEMBER_ADD, address, complete, destroy, user_data) : 0;
+}
+
+guint
+mtk_ims_call_remove_participant(
+    BinderExtCall* ext,
+    const char* address,
+    BinderExtCallResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data)
+{
+    return G_LIKELY(ext) ? mtk_ims_call_control_participant(ext,
+        IMS_CONF_MEMBER_REMOVE, address, complete, destroy, user_data) : 0;
+}
+
+gulong
+mtk_ims_call_add_conf_participant_handler(
+    BinderExtCall* ext,
+    MtkImsCallConfParticipantFunc handler,
+    void* user_data)
+{
+    return (G_LIKELY(ext) && G_LIKELY(handler)) ? g_signal_connect(THIS(ext),
+        SIGNAL_CONF_PARTICIPANT_NAME, G_CALLBACK(handler), user_data) : 0;
+}
+
+void
+mtk_ims_call_set_dtmf_pause(
+    BinderExtCall* ext,
+    const char* chars,
+    guint ms)
+{
+    if (G_LIKELY(ext)) {
+        MtkImsCall* self = THIS(ext);
+
+        if (chars) {
+            g_free(self->dtmf_pause_chars);
+            self->dtmf_pause_chars = g_strdup(chars);
+        }
+        if (ms) {
+            self->dtmf_pause_ms = ms;
+        }
+    }
+}
+
+const MtkRadioExtLatency*
+mtk_ims_call_answer_latency(
+    BinderExtCall* ext)
+{
+    return G_LIKELY(ext) ? &THIS(ext)->answer_latency : NULL;
+}
+
+const MtkRadioExtLatency*
+mtk_ims_call_hold_latency(
+    BinderExtCall* ext)
+{
+    return G_LIKELY(ext) ? &THIS(ext)->hold_latency : NULL;
+}
+
+gulong
+mtk_ims_call_add_speech_codec_handler(
+    BinderExtCall* ext,
+    MtkImsCallSpeechCodecFunc handler,
+    void* user_data)
+{
+    return (G_LIKELY(ext) && G_LIKELY(handler)) ? g_signal_connect(THIS(ext),
+        SIGNAL_SPEECH_CODEC_NAME, G_CALLBACK(handler), user_data) : 0;
+}
+
+SpeechCodec
+mtk_ims_call_speech_codec(
+    BinderExtCall* ext,
+    guint call_id)
+{
+    const MtkImsCallEntry* entry = G_LIKELY(ext) ?
+        g_hash_table_lookup(THIS(ext)->call_table, ID_KEY(call_id)) : NULL;
+
+    return entry ? entry->codec : SPEECH_CODEC_UNKNOWN;
+}
+
+gulong
+mtk_ims_call_add_rat_handler(
+    BinderExtCall* ext,
+    MtkImsCallRatFunc handler,
+    void* user_data)
+{
+    return (G_LIKELY(ext) && G_LIKELY(handler)) ? g_signal_connect(THIS(ext),
+        SIGNAL_CALL_RAT_NAME, G_CALLBACK(handler), user_data) : 0;
+}
+
+gboolean
+mtk_ims_call_rat_stats(
+    BinderExtCall* ext,
+    guint call_id,
+    MtkImsCallRatStats* stats)
+{
+    MtkImsCallEntry* entry = G_LIKELY(ext) ?
+        g_hash_table_lookup(THIS(ext)->call_table, ID_KEY(call_id)) : NULL;
+
+    if (entry) {
+        /* Include the time spent on the current RAT so far */
+        mtk_ims_call_rat_update(entry, g_get_monotonic_time());
+        *stats = entry->rat;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+guint
+mtk_ims_call_handovers(
+    BinderExtCall* ext,
+    CallRat rat)
+{
+    return (G_LIKELY(ext) && rat < CALL_RAT_COUNT) ?
+        THIS(ext)->handovers[rat] : 0;
+}
+
+MtkCdr*
+mtk_ims_call_cdr(
+    BinderExtCall* ext)
+{
+    return G_LIKELY(ext) ? THIS(ext)->cdr : NULL;
+}
+
+MtkSsac*
+mtk_ims_call_ssac(
+    BinderExtCall* ext)
+{
+    return G_LIKELY(ext) ? THIS(ext)->ssac : NULL;
+}
+
+const MtkRadioExtLatency*
+mtk_ims_call_dial_latency(
+    BinderExtCall* ext,
+    MTK_IMS_CALL_DIAL_PATH path)
+{
+    return (G_LIKELY(ext) && path < MTK_IMS_CALL_DIAL_PATH_COUNT) ?
+        (THIS(ext)->dial_latency + path) : NULL;
+}
+
 /*==========================================================================*
  * Internals
  *==========================================================================*/
@@ -520,11 +2126,23 @@ mtk_ims_call_finalize(
 {
     MtkImsCall* self = THIS(object);
 
+    if (self->calls_changed_id) {
+        g_source_remove(self->calls_changed_id);
+    }
+    gutil_disconnect_handlers(self->radio_ext, self->radio_ext_event_id,
+        G_N_ELEMENTS(self->radio_ext_event_id));
     mtk_radio_ext_unref(self->radio_ext);
+    mtk_conf_info_free(self->conf_info);
+    mtk_cdr_free(self->cdr);
+    mtk_ssac_free(self->ssac);
     radio_client_unref(self->ims_aosp_client);
     gutil_idle_pool_destroy(self->pool);
-    gutil_ptrv_free((void**)self->calls);
+    g_ptr_array_free(self->calls, TRUE);
+    g_hash_table_destroy(self->call_table);
+    g_hash_table_destroy(self->zombies);
     g_hash_table_unref(self->id_map);
+    g_free(self->dtmf_pause_chars);
+    g_free(self->ecc_number);
     G_OBJECT_CLASS(PARENT_CLASS)->finalize(object);
 }
 
@@ -534,7 +2152,20 @@ mtk_ims_call_init(
     MtkImsCall* self)
 {
     self->pool = gutil_idle_pool_new();
+    self->calls = g_ptr_array_new();
+    g_ptr_array_add(self->calls, NULL);
+    self->call_table = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+        NULL, g_free);
     self->id_map = g_hash_table_new(g_direct_hash, g_direct_equal);
+    g_queue_init(&self->dial_queue);
+    self->zombies = g_hash_table_new(g_direct_hash, g_direct_equal);
+    g_queue_init(&self->dtmf_queue);
+    self->dtmf_pause_chars = g_strdup(MTK_IMS_CALL_DTMF_PAUSE_CHARS);
+    self->dtmf_pause_ms = MTK_IMS_CALL_DTMF_PAUSE_MS;
+    self->conf_info = mtk_conf_info_new(mtk_ims_call_conf_participant_changed,
+        self);
+    self->cdr = mtk_cdr_new(MTK_IMS_CALL_CDR_SIZE);
+    self->ssac = mtk_ssac_new();
 }
 
 static
@@ -559,6 +2190,18 @@ mtk_ims_call_class_init(
         g_signal_new(SIGNAL_CALL_SUPP_SVC_NOTIFY_NAME, type,
             G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
             1, G_TYPE_POINTER);
+    mtk_ims_call_signals[SIGNAL_CONF_PARTICIPANT] =
+        g_signal_new(SIGNAL_CONF_PARTICIPANT_NAME, type,
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
+            2, G_TYPE_POINTER, G_TYPE_BOOLEAN);
+    mtk_ims_call_signals[SIGNAL_CALL_RAT] =
+        g_signal_new(SIGNAL_CALL_RAT_NAME, type,
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
+            2, G_TYPE_UINT, G_TYPE_POINTER);
+    mtk_ims_call_signals[SIGNAL_SPEECH_CODEC] =
+        g_signal_new(SIGNAL_SPEECH_CODEC_NAME, type,
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
+            2, G_TYPE_INT, G_TYPE_UINT);
 }
 
 /*
@@ -20,6 +20,49 @@
 
 typedef struct mtk_radio_ext MtkRadioExt;
 typedef struct radio_client RadioClient;
+typedef struct mtk_radio_ext_latency MtkRadioExtLatency;
+typedef struct mtk_conf_participant MtkConfParticipant;
+typedef struct mtk_cdr MtkCdr;
+typedef struct mtk_ssac MtkSsac;
+typedef enum speech_codec SpeechCodec;
+typedef enum call_rat_domain CallRatDomain;
+typedef enum call_rat CallRat;
+
+/* Per-call bearer, indexed by CallRat */
+typedef struct mtk_ims_call_rat_stats {
+    CallRatDomain domain;
+    CallRat rat;
+    guint handovers; /* Between LTE and Wi-Fi */
+    gint64 time[3]; /* Microseconds spent on each RAT, CALL_RAT_COUNT */
+} MtkImsCallRatStats;
+
+/* Emitted when the RAT of a call changes */
+typedef void (*MtkImsCallRatFunc)(
+    BinderExtCall* ext,
+    guint call_id,
+    const MtkImsCallRatStats* stats,
+    void* user_data);
+
+typedef enum mtk_ims_call_dial_path {
+    MTK_IMS_CALL_DIAL_PATH_NORMAL,   /* IRadio dial on imsAosp */
+    MTK_IMS_CALL_DIAL_PATH_SIP_URI,  /* IMtkRadioEx dialWithSipUri */
+    MTK_IMS_CALL_DIAL_PATH_EMERGENCY, /* setEccMode, then dial */
+    MTK_IMS_CALL_DIAL_PATH_COUNT
+} MTK_IMS_CALL_DIAL_PATH;
+
+/* sample_rate is in Hz, zero if unknown */
+typedef void (*MtkImsCallSpeechCodecFunc)(
+    BinderExtCall* ext,
+    SpeechCodec codec,
+    guint sample_rate,
+    void* user_data);
+
+/* Participant is only valid for the duration of the call */
+typedef void (*MtkImsCallConfParticipantFunc)(
+    BinderExtCall* ext,
+    const MtkConfParticipant* participant,
+    gboolean removed,
+    void* user_data);
 
 BinderExtCall*
 mtk_ims_call_new(
@@ -27,6 +70,114 @@ mtk_ims_call_new(
     RadioClient* ims_aosp_client)
     G_GNUC_INTERNAL;
 
+guint
+mtk_ims_call_count(
+    BinderExtCall* ext)
+    G_GNUC_INTERNAL;
+
+/* Invite or drop a conference participant by number or SIP URI */
+guint
+mtk_ims_call_add_participant(
+    BinderExtCall* ext,
+    const char* address,
+    BinderExtCallResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data)
+    G_GNUC_INTERNAL;
+
+guint
+mtk_ims_call_remove_participant(
+    BinderExtCall* ext,
+    const char* address,
+    BinderExtCallResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data)
+    G_GNUC_INTERNAL;
+
+gulong
+mtk_ims_call_add_conf_participant_handler(
+    BinderExtCall* ext,
+    MtkImsCallConfParticipantFunc handler,
+    void* user_data)
+    G_GNUC_INTERNAL;
+
+/*
+ * Each pause character delays the following tones by ms.
+ * NULL chars or zero ms keep the current value.
+ */
+void
+mtk_ims_call_set_dtmf_pause(
+    BinderExtCall* ext,
+    const char* chars,
+    guint ms)
+    G_GNUC_INTERNAL;
+
+/* From sending answer to the call becoming active */
+const MtkRadioExtLatency*
+mtk_ims_call_answer_latency(
+    BinderExtCall* ext)
+    G_GNUC_INTERNAL;
+
+/* From sending hold to the call being held */
+const MtkRadioExtLatency*
+mtk_ims_call_hold_latency(
+    BinderExtCall* ext)
+    G_GNUC_INTERNAL;
+
+/* Emitted as soon as the codec is known, usually before CONNECTED */
+gulong
+mtk_ims_call_add_speech_codec_handler(
+    BinderExtCall* ext,
+    MtkImsCallSpeechCodecFunc handler,
+    void* user_data)
+    G_GNUC_INTERNAL;
+
+SpeechCodec
+mtk_ims_call_speech_codec(
+    BinderExtCall* ext,
+    guint call_id)
+    G_GNUC_INTERNAL;
+
+gulong
+mtk_ims_call_add_rat_handler(
+    BinderExtCall* ext,
+    MtkImsCallRatFunc handler,
+    void* user_data)
+    G_GNUC_INTERNAL;
+
+gboolean
+mtk_ims_call_rat_stats(
+    BinderExtCall* ext,
+    guint call_id,
+    MtkImsCallRatStats* stats)
+    G_GNUC_INTERNAL;
+
+/* Number of handovers to the given RAT, all calls */
+guint
+mtk_ims_call_handovers(
+    BinderExtCall* ext,
+    CallRat rat)
+    G_GNUC_INTERNAL;
+
+/* Call detail records, owned by the call object */
+MtkCdr*
+mtk_ims_call_cdr(
+    BinderExtCall* ext)
+    G_GNUC_INTERNAL;
+
+/* SSAC barring of dials, owned by the call object */
+MtkSsac*
+mtk_ims_call_ssac(
+    BinderExtCall* ext)
+    G_GNUC_INTERNAL;
+
+/* From sending dial to the modem assigning a call id */
+const MtkRadioExtLatency*
+mtk_ims_call_dial_latency(
+    BinderExtCall* ext,
+    MTK_IMS_CALL_DIAL_PATH path)
+    G_GNUC_INTERNAL;
+
 #endif /* MTK_IMS_CALL_H */
 
 /*
@@ -0,0 +1,359 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include "mtk_ims_cfg.h"
+#include "mtk_radio_ext.h"
+
+#include <ofono/log.h>
+
+#include <gutil_misc.h>
+
+/* ImsConfig.ConfigConstants up to PROVISIONED_CONFIG_END */
+#define MTK_IMS_CFG_LAST_ID (66)
+
+/* The whole bulk read, normally takes well under a second */
+#define MTK_IMS_CFG_READ_TIMEOUT_SEC (30)
+
+/* Must be a power of 2 */
+#define MTK_IMS_CFG_MIN_SIZE (128)
+
+enum mtk_ims_cfg_radio_events {
+    RADIO_EVENT_CHANGED,
+    RADIO_EVENT_LOADED,
+    RADIO_EVENT_COUNT
+};
+
+/* Keys are interned, comparing pointers is enough */
+typedef struct mtk_ims_cfg_entry {
+    const char* key;
+    char* value;
+} MtkImsCfgEntry;
+
+struct mtk_ims_cfg {
+    MtkRadioExt* radio;
+    gulong radio_event_id[RADIO_EVENT_COUNT];
+    MtkImsCfgEntry* table;
+    guint size;
+    guint count;
+    int next_id;
+    guint req_id;
+    guint timeout_id;
+    gboolean loaded;
+    MtkImsCfgFunc loaded_func;
+    void* loaded_data;
+};
+
+static
+guint
+mtk_ims_cfg_hash(
+    const char* key)
+{
+    /* Fibonacci hashing of the address */
+    return (guint)(((gsize)key >> 3) * 2654435761u);
+}
+
+static
+MtkImsCfgEntry*
+mtk_ims_cfg_slot(
+    MtkImsCfgEntry* table,
+    guint size,
+    const char* key)
+{
+    const guint mask = size - 1;
+    guint i = mtk_ims_cfg_hash(key) & mask;
+
+    /* Linear probing, there's always a free slot */
+    while (table[i].key && table[i].key != key) {
+        i = (i + 1) & mask;
+    }
+    return table + i;
+}
+
+static
+void
+mtk_ims_cfg_grow(
+    MtkImsCfg* cfg)
+{
+    MtkImsCfgEntry* old = cfg->table;
+    const guint old_size = cfg->size;
+    guint i;
+
+    cfg->size = old_size ? (old_size * 2) : MTK_IMS_CFG_MIN_SIZE;
+    cfg->table = g_new0(MtkImsCfgEntry, cfg->size);
+    for (i = 0; i < old_size; i++) {
+        if (old[i].key) {
+            *mtk_ims_cfg_slot(cfg->table, cfg->size, old[i].key) = old[i];
+        }
+    }
+    g_free(old);
+}
+
+static
+void
+mtk_ims_cfg_set(
+    MtkImsCfg* cfg,
+    const char* key,
+    const char* value)
+{
+    MtkImsCfgEntry* entry;
+
+    /* Keep the load factor under 1/2 */
+    if ((cfg->count + 1) * 2 > cfg->size) {
+        mtk_ims_cfg_grow(cfg);
+    }
+
+    entry = mtk_ims_cfg_slot(cfg->table, cfg->size, key);
+    if (!entry->key) {
+        entry->key = key;
+        entry->value = g_strdup(value);
+        cfg->count++;
+    } else if (g_strcmp0(entry->value, value)) {
+        g_free(entry->value);
+        entry->value = g_strdup(value);
+    }
+}
+
+static
+void
+mtk_ims_cfg_changed(
+    MtkRadioExt* radio,
+    const char* config_id,
+    const char* value,
+    void* user_data)
+{
+    mtk_ims_cfg_set((MtkImsCfg*)user_data, config_id, value);
+}
+
+static
+void
+mtk_ims_cfg_read_next(
+    MtkImsCfg* cfg);
+
+static
+void
+mtk_ims_cfg_read_finish(
+    MtkImsCfg* cfg)
+{
+    if (cfg->timeout_id) {
+        g_source_remove(cfg->timeout_id);
+        cfg->timeout_id = 0;
+    }
+    DBG("%u IMS config value(s)", cfg->count);
+    cfg->loaded = TRUE;
+    if (cfg->loaded_func) {
+        cfg->loaded_func(cfg, cfg->loaded_data);
+    }
+}
+
+static
+gboolean
+mtk_ims_cfg_read_timeout(
+    gpointer user_data)
+{
+    MtkImsCfg* cfg = user_data;
+
+    /* Whatever has been read by now is what we have */
+    ofono_warn("IMS config read timed out at id %d", cfg->next_id);
+    cfg->timeout_id = 0;
+    mtk_radio_ext_cancel(cfg->radio, cfg->req_id);
+    cfg->req_id = 0;
+    cfg->next_id = MTK_IMS_CFG_LAST_ID + 1;
+    mtk_ims_cfg_read_finish(cfg);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+mtk_ims_cfg_read_done(
+    MtkRadioExt* radio,
+    int result,
+    void* user_data)
+{
+    MtkImsCfg* cfg = user_data;
+
+    /* Unsupported ids fail, that's fine */
+    cfg->req_id = 0;
+    cfg->next_id++;
+    mtk_ims_cfg_read_next(cfg);
+}
+
+static
+void
+mtk_ims_cfg_read_next(
+    MtkImsCfg* cfg)
+{
+    /* One request at a time, the modem handles them serially anyway */
+    while (cfg->next_id <= MTK_IMS_CFG_LAST_ID) {
+        cfg->req_id = mtk_radio_ext_get_ims_cfg_provision_value(cfg->radio,
+            cfg->next_id, mtk_ims_cfg_read_done, NULL, cfg);
+        if (cfg->req_id) {
+            return;
+        }
+        /* Couldn't even be submitted, don't get stuck on it */
+        cfg->next_id++;
+    }
+    mtk_ims_cfg_read_finish(cfg);
+}
+
+static
+void
+mtk_ims_cfg_read_all(
+    MtkImsCfg* cfg)
+{
+    mtk_radio_ext_cancel(cfg->radio, cfg->req_id);
+    cfg->req_id = 0;
+    cfg->next_id = 0;
+    if (cfg->timeout_id) {
+        g_source_remove(cfg->timeout_id);
+    }
+    cfg->timeout_id = g_timeout_add_seconds(MTK_IMS_CFG_READ_TIMEOUT_SEC,
+        mtk_ims_cfg_read_timeout, cfg);
+    mtk_ims_cfg_read_next(cfg);
+}
+
+static
+void
+mtk_ims_cfg_loaded_event(
+    MtkRadioExt* radio,
+    void* user_data)
+{
+    mtk_ims_cfg_read_all((MtkImsCfg*)user_data);
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+MtkImsCfg*
+mtk_ims_cfg_new(
+    MtkRadioExt* radio)
+{
+    MtkImsCfg* cfg = g_new0(MtkImsCfg, 1);
+
+    cfg->radio = mtk_radio_ext_ref(radio);
+    cfg->radio_event_id[RADIO_EVENT_CHANGED] =
+        mtk_radio_ext_add_ims_cfg_changed_handler(radio,
+            mtk_ims_cfg_changed, cfg);
+    cfg->radio_event_id[RADIO_EVENT_LOADED] =
+        mtk_radio_ext_add_ims_cfg_loaded_handler(radio,
+            mtk_ims_cfg_loaded_event, cfg);
+
+    /* imsCfgConfigLoaded may have been sent before we started */
+    mtk_ims_cfg_read_all(cfg);
+    return cfg;
+}
+
+void
+mtk_ims_cfg_free(
+    MtkImsCfg* cfg)
+{
+    if (cfg) {
+        guint i;
+
+        if (cfg->timeout_id) {
+            g_source_remove(cfg->timeout_id);
+        }
+        mtk_radio_ext_cancel(cfg->radio, cfg->req_id);
+        gutil_disconnect_handlers(cfg->radio, cfg->radio_event_id,
+            G_N_ELEMENTS(cfg->radio_event_id));
+        mtk_radio_ext_unref(cfg->radio);
+        for (i = 0; i < cfg->size; i++) {
+            g_free(cfg->table[i].value);
+        }
+        g_free(cfg->table);
+        g_free(cfg);
+    }
+}
+
+void
+mtk_ims_cfg_set_loaded_func(
+    MtkImsCfg* cfg,
+    MtkImsCfgFunc func,
+    void* user_data)
+{
+    if (G_LIKELY(cfg)) {
+        cfg->loaded_func = func;
+        cfg->loaded_data = user_data;
+    }
+}
+
+gboolean
+mtk_ims_cfg_loaded(
+    MtkImsCfg* cfg)
+{
+    return G_LIKELY(cfg) && cfg->loaded;
+}
+
+guint
+mtk_ims_cfg_count(
+    MtkImsCfg* cfg)
+{
+    return G_LIKELY(cfg) ? cfg->count : 0;
+}
+
+const char*
+mtk_ims_cfg_get(
+    MtkImsCfg* cfg,
+    const char* config_id)
+{
+    if (G_LIKELY(cfg) && cfg->count && config_id) {
+        /* A string which has never been interned can't be a key */
+        const GQuark q = g_quark_try_string(config_id);
+
+        if (q) {
+            return mtk_ims_cfg_slot(cfg->table, cfg->size,
+                g_quark_to_string(q))->value;
+        }
+    }
+    return NULL;
+}
+
+const char*
+mtk_ims_cfg_get_id(
+    MtkImsCfg* cfg,
+    int config_id)
+{
+    char buf[16];
+
+    snprintf(buf, sizeof(buf), "%d", config_id);
+    return mtk_ims_cfg_get(cfg, buf);
+}
+
+void
+mtk_ims_cfg_foreach(
+    MtkImsCfg* cfg,
+    MtkImsCfgForeachFunc func,
+    void* user_data)
+{
+    if (G_LIKELY(cfg) && G_LIKELY(func)) {
+        guint i;
+
+        for (i = 0; i < cfg->size; i++) {
+            const MtkImsCfgEntry* entry = cfg->table + i;
+
+            if (entry->key) {
+                func(entry->key, entry->value, user_data);
+            }
+        }
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
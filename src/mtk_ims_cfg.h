@@ -0,0 +1,97 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#ifndef MTK_IMS_CFG_H
+#define MTK_IMS_CFG_H
+
+#include <glib.h>
+
+/*
+ * Local copy of the modem's IMS provisioning config. It's read in bulk
+ * once the modem has loaded its config and then follows imsCfgConfigChanged,
+ * so reads never go through binder. Config ids are decimal strings, as in
+ * imsCfgConfigChanged.
+ */
+
+typedef struct mtk_ims_cfg MtkImsCfg;
+typedef struct mtk_radio_ext MtkRadioExt;
+
+typedef void (*MtkImsCfgFunc)(
+    MtkImsCfg* cfg,
+    void* user_data);
+
+typedef void (*MtkImsCfgForeachFunc)(
+    const char* config_id,
+    const char* value,
+    void* user_data);
+
+MtkImsCfg*
+mtk_ims_cfg_new(
+    MtkRadioExt* radio)
+    G_GNUC_INTERNAL;
+
+void
+mtk_ims_cfg_free(
+    MtkImsCfg* cfg)
+    G_GNUC_INTERNAL;
+
+/* Called each time the bulk read completes */
+void
+mtk_ims_cfg_set_loaded_func(
+    MtkImsCfg* cfg,
+    MtkImsCfgFunc func,
+    void* user_data)
+    G_GNUC_INTERNAL;
+
+/* TRUE once the bulk read has completed */
+gboolean
+mtk_ims_cfg_loaded(
+    MtkImsCfg* cfg)
+    G_GNUC_INTERNAL;
+
+guint
+mtk_ims_cfg_count(
+    MtkImsCfg* cfg)
+    G_GNUC_INTERNAL;
+
+/* NULL if the value is unknown */
+const char*
+mtk_ims_cfg_get(
+    MtkImsCfg* cfg,
+    const char* config_id)
+    G_GNUC_INTERNAL;
+
+const char*
+mtk_ims_cfg_get_id(
+    MtkImsCfg* cfg,
+    int config_id)
+    G_GNUC_INTERNAL;
+
+void
+mtk_ims_cfg_foreach(
+    MtkImsCfg* cfg,
+    MtkImsCfgForeachFunc func,
+    void* user_data)
+    G_GNUC_INTERNAL;
+
+#endif /* MTK_IMS_CFG_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
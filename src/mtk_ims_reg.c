@@ -0,0 +1,192 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include "mtk_ims_reg.h"
+
+#include <ofono/log.h>
+
+typedef struct mtk_ims_reg_input {
+    BINDER_EXT_IMS_STATE state;
+    guint seq; /* Zero if nothing has been reported yet */
+} MtkImsRegInput;
+
+struct mtk_ims_reg {
+    char* slot;
+    MtkImsRegInput input[MTK_IMS_REG_SOURCE_COUNT];
+    guint seq;
+    guint eval_seq; /* The last seq taken into account */
+    guint eval_id;
+    guint debounce_id;
+    BINDER_EXT_IMS_STATE state;
+    BINDER_EXT_IMS_STATE pending_state;
+    guint flaps; /* Suppressed by debouncing */
+    MtkImsRegFunc func;
+    void* user_data;
+};
+
+static
+const char*
+mtk_ims_reg_state_name(
+    BINDER_EXT_IMS_STATE state)
+{
+    switch (state) {
+    case BINDER_EXT_IMS_STATE_NOT_REGISTERED: return "not registered";
+    case BINDER_EXT_IMS_STATE_REGISTERING: return "registering";
+    case BINDER_EXT_IMS_STATE_REGISTERED: return "registered";
+    case BINDER_EXT_IMS_STATE_UNKNOWN: break;
+    }
+    return "unknown";
+}
+
+static
+void
+mtk_ims_reg_commit(
+    MtkImsReg* self,
+    BINDER_EXT_IMS_STATE state)
+{
+    if (self->state != state) {
+        DBG("%s %s => %s", self->slot, mtk_ims_reg_state_name(self->state),
+            mtk_ims_reg_state_name(state));
+        self->state = state;
+        self->func(self, state, self->user_data);
+    }
+}
+
+static
+gboolean
+mtk_ims_reg_debounce_timeout(
+    gpointer user_data)
+{
+    MtkImsReg* self = user_data;
+
+    self->debounce_id = 0;
+    mtk_ims_reg_commit(self, self->pending_state);
+    return G_SOURCE_REMOVE;
+}
+
+static
+gboolean
+mtk_ims_reg_evaluate(
+    gpointer user_data)
+{
+    MtkImsReg* self = user_data;
+    const MtkImsRegInput* best = NULL;
+    int i;
+
+    self->eval_id = 0;
+
+    /* Highest priority source among the ones updated since last time */
+    for (i = MTK_IMS_REG_SOURCE_COUNT - 1; i >= 0 && !best; i--) {
+        if (self->input[i].seq > self->eval_seq) {
+            best = self->input + i;
+        }
+    }
+    self->eval_seq = self->seq;
+
+    if (!best) {
+        return G_SOURCE_REMOVE;
+    }
+
+    if (best->state == BINDER_EXT_IMS_STATE_REGISTERED) {
+        if (self->debounce_id) {
+            self->flaps++;
+            DBG("%s registration restored, %u flap(s) suppressed",
+                self->slot, self->flaps);
+            g_source_remove(self->debounce_id);
+            self->debounce_id = 0;
+        }
+        mtk_ims_reg_commit(self, best->state);
+    } else if (self->state == BINDER_EXT_IMS_STATE_REGISTERED) {
+        /* Give the modem a chance to re-register */
+        self->pending_state = best->state;
+        if (!self->debounce_id) {
+            self->debounce_id = g_timeout_add(MTK_IMS_REG_DEBOUNCE_MS,
+                mtk_ims_reg_debounce_timeout, self);
+        }
+    } else {
+        mtk_ims_reg_commit(self, best->state);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+MtkImsReg*
+mtk_ims_reg_new(
+    const char* slot,
+    MtkImsRegFunc func,
+    void* user_data)
+{
+    MtkImsReg* self = g_new0(MtkImsReg, 1);
+
+    self->slot = g_strdup(slot);
+    self->state = BINDER_EXT_IMS_STATE_NOT_REGISTERED;
+    self->func = func;
+    self->user_data = user_data;
+    return self;
+}
+
+void
+mtk_ims_reg_free(
+    MtkImsReg* self)
+{
+    if (self) {
+        if (self->eval_id) {
+            g_source_remove(self->eval_id);
+        }
+        if (self->debounce_id) {
+            g_source_remove(self->debounce_id);
+        }
+        g_free(self->slot);
+        g_free(self);
+    }
+}
+
+void
+mtk_ims_reg_update(
+    MtkImsReg* self,
+    MTK_IMS_REG_SOURCE source,
+    BINDER_EXT_IMS_STATE state)
+{
+    if (G_LIKELY(self) && source < MTK_IMS_REG_SOURCE_COUNT &&
+        state != BINDER_EXT_IMS_STATE_UNKNOWN) {
+        MtkImsRegInput* input = self->input + source;
+
+        input->state = state;
+        input->seq = ++(self->seq);
+
+        /* Let the indications received together settle */
+        if (!self->eval_id) {
+            self->eval_id = g_idle_add(mtk_ims_reg_evaluate, self);
+        }
+    }
+}
+
+BINDER_EXT_IMS_STATE
+mtk_ims_reg_state(
+    MtkImsReg* self)
+{
+    return G_LIKELY(self) ? self->state : BINDER_EXT_IMS_STATE_UNKNOWN;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
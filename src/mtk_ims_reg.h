@@ -0,0 +1,81 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#ifndef MTK_IMS_REG_H
+#define MTK_IMS_REG_H
+
+#include <binder_ext_ims.h>
+
+/*
+ * IMS registration state machine. The modem reports the registration
+ * state through three different indications which don't always agree
+ * and don't arrive in any particular order. Updates received within
+ * the same main loop iteration are resolved by priority, otherwise the
+ * most recent one wins. Dropping out of the registered state is held
+ * back for a while, so that short re-registrations don't reach oFono.
+ */
+
+typedef struct mtk_ims_reg MtkImsReg;
+
+/* How long to wait before reporting the loss of registration */
+#define MTK_IMS_REG_DEBOUNCE_MS (2000)
+
+/* In the order of increasing priority */
+typedef enum mtk_ims_reg_source {
+    MTK_IMS_REG_SOURCE_STATUS_REPORT,     /* imsRegStatusReport */
+    MTK_IMS_REG_SOURCE_REG_INFO,          /* imsRegInfoInd */
+    MTK_IMS_REG_SOURCE_REGISTRATION_INFO, /* imsRegistrationInfo */
+    MTK_IMS_REG_SOURCE_COUNT
+} MTK_IMS_REG_SOURCE;
+
+typedef void (*MtkImsRegFunc)(
+    MtkImsReg* reg,
+    BINDER_EXT_IMS_STATE state,
+    void* user_data);
+
+MtkImsReg*
+mtk_ims_reg_new(
+    const char* slot,
+    MtkImsRegFunc func,
+    void* user_data)
+    G_GNUC_INTERNAL;
+
+void
+mtk_ims_reg_free(
+    MtkImsReg* reg)
+    G_GNUC_INTERNAL;
+
+/* BINDER_EXT_IMS_STATE_UNKNOWN is ignored */
+void
+mtk_ims_reg_update(
+    MtkImsReg* reg,
+    MTK_IMS_REG_SOURCE source,
+    BINDER_EXT_IMS_STATE state)
+    G_GNUC_INTERNAL;
+
+BINDER_EXT_IMS_STATE
+mtk_ims_reg_state(
+    MtkImsReg* reg)
+    G_GNUC_INTERNAL;
+
+#endif /* MTK_IMS_REG_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -177,6 +177,12 @@ mtk_ims_sms_send(
 
     DBG("Sending SMS over IMS: smsc=%s, pdu_len=%zu, msg_ref=%u", smsc, pdu_len, msg_ref);
 
+    if (!mtk_radio_ext_ims_service_available(self->radio_ext,
+        MTK_RADIO_EXT_IMS_SERVICE_SMS)) {
+        DBG("SMS is not registered with IMS");
+        return 0;
+    }
+
     req = mtk_ims_sms_result_request_new(self, complete, destroy, user_data);
 
     ret = mtk_radio_ext_send_ims_sms_ex(self->radio_ext, smsc, pdu, pdu_len,
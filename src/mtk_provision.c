@@ -0,0 +1,345 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include "mtk_provision.h"
+#include "mtk_ims_cfg.h"
+#include "mtk_radio_ext.h"
+
+#include <ofono/log.h>
+
+#include <stdlib.h>
+
+#define MTK_PROVISION_GROUP_IMS_CFG "ImsCfg"
+#define MTK_PROVISION_GROUP_PROVISION "Provision"
+
+/* Requests in flight, the RIL queues the rest anyway */
+#define MTK_PROVISION_WINDOW (4)
+
+typedef struct mtk_provision_item {
+    MtkProvision* provision;
+    const char* group;
+    char* key;
+    char* value;
+    int config_id; /* -1 for setProvisionValue */
+    guint req_id;
+} MtkProvisionItem;
+
+struct mtk_provision {
+    MtkRadioExt* radio;
+    MtkImsCfg* cfg;
+    char* cache_file;
+    GKeyFile* cache;
+    gboolean cache_changed;
+    GKeyFile* profile;
+    GPtrArray* queue;
+    guint next;
+    guint in_flight;
+    guint sent;
+    guint failed;
+    MtkProvisionDoneFunc done;
+    void* done_data;
+};
+
+static
+void
+mtk_provision_item_free(
+    gpointer data)
+{
+    MtkProvisionItem* item = data;
+
+    g_free(item->key);
+    g_free(item->value);
+    g_free(item);
+}
+
+static
+void
+mtk_provision_cancel(
+    MtkProvision* self)
+{
+    guint i;
+
+    for (i = 0; i < self->next; i++) {
+        MtkProvisionItem* item = self->queue->pdata[i];
+
+        mtk_radio_ext_cancel(self->radio, item->req_id);
+    }
+    g_ptr_array_set_size(self->queue, 0);
+    if (self->profile) {
+        mtk_ims_cfg_set_loaded_func(self->cfg, NULL, NULL);
+        g_key_file_unref(self->profile);
+        self->profile = NULL;
+    }
+    self->next = self->in_flight = self->sent = self->failed = 0;
+    self->done = NULL;
+    self->done_data = NULL;
+}
+
+static
+void
+mtk_provision_finish(
+    MtkProvision* self)
+{
+    MtkProvisionDoneFunc done = self->done;
+    void* done_data = self->done_data;
+    const guint sent = self->sent;
+    const guint failed = self->failed;
+
+    if (self->cache_changed) {
+        GError* error = NULL;
+
+        if (!g_key_file_save_to_file(self->cache, self->cache_file, &error)) {
+            ofono_warn("Failed to save %s: %s", self->cache_file,
+                error->message);
+            g_error_free(error);
+        }
+        self->cache_changed = FALSE;
+    }
+
+    DBG("%u provisioning request(s), %u failed", sent, failed);
+    mtk_provision_cancel(self);
+    if (done) {
+        done(self, sent, failed, done_data);
+    }
+}
+
+static
+void
+mtk_provision_pump(
+    MtkProvision* self);
+
+static
+void
+mtk_provision_sent(
+    MtkRadioExt* radio,
+    int result,
+    void* user_data)
+{
+    MtkProvisionItem* item = user_data;
+    MtkProvision* self = item->provision;
+
+    item->req_id = 0;
+    self->in_flight--;
+    if (result == RADIO_ERROR_NONE) {
+        g_key_file_set_string(self->cache, item->group, item->key,
+            item->value);
+        self->cache_changed = TRUE;
+    } else {
+        DBG("%s %s=%s failed: %d", item->group, item->key, item->value,
+            result);
+        self->failed++;
+    }
+    mtk_provision_pump(self);
+}
+
+static
+void
+mtk_provision_pump(
+    MtkProvision* self)
+{
+    while (self->in_flight < MTK_PROVISION_WINDOW &&
+        self->next < self->queue->len) {
+        MtkProvisionItem* item = self->queue->pdata[self->next++];
+
+        item->req_id = (item->config_id >= 0) ?
+            mtk_radio_ext_set_ims_cfg_provision_value(self->radio,
+                item->config_id, item->value, mtk_provision_sent,
+                NULL, item) :
+            mtk_radio_ext_set_provision_value(self->radio,
+                item->key, item->value, mtk_provision_sent,
+                NULL, item);
+        self->sent++;
+        if (item->req_id) {
+            self->in_flight++;
+        } else {
+            self->failed++;
+        }
+    }
+    if (!self->in_flight && self->next >= self->queue->len) {
+        mtk_provision_finish(self);
+    }
+}
+
+static
+void
+mtk_provision_add(
+    MtkProvision* self,
+    const char* group,
+    const char* key,
+    int config_id,
+    const char* value)
+{
+    char* cached = g_key_file_get_string(self->cache, group, key, NULL);
+    const char* current = (config_id >= 0) ?
+        mtk_ims_cfg_get(self->cfg, key) : NULL;
+
+    /* The modem knows better than the cache */
+    if (g_strcmp0(current ? current : cached, value)) {
+        MtkProvisionItem* item = g_new0(MtkProvisionItem, 1);
+
+        item->provision = self;
+        item->group = group;
+        item->key = g_strdup(key);
+        item->value = g_strdup(value);
+        item->config_id = config_id;
+        g_ptr_array_add(self->queue, item);
+    }
+    g_free(cached);
+}
+
+static
+void
+mtk_provision_start(
+    MtkProvision* self)
+{
+    GKeyFile* profile = self->profile;
+    char** keys;
+    guint i;
+
+    keys = g_key_file_get_keys(profile, MTK_PROVISION_GROUP_IMS_CFG, NULL,
+        NULL);
+    for (i = 0; keys && keys[i]; i++) {
+        char* value = g_key_file_get_string(profile,
+            MTK_PROVISION_GROUP_IMS_CFG, keys[i], NULL);
+        char* end = NULL;
+        const long id = strtol(keys[i], &end, 10);
+
+        if (value && end != keys[i] && !*end && id >= 0 && id <= G_MAXINT) {
+            char* key = g_strdup_printf("%ld", id);
+
+            mtk_provision_add(self, MTK_PROVISION_GROUP_IMS_CFG, key,
+                (int)id, value);
+            g_free(key);
+        } else {
+            ofono_warn("Invalid IMS config %s", keys[i]);
+        }
+        g_free(value);
+    }
+    g_strfreev(keys);
+
+    keys = g_key_file_get_keys(profile, MTK_PROVISION_GROUP_PROVISION, NULL,
+        NULL);
+    for (i = 0; keys && keys[i]; i++) {
+        char* value = g_key_file_get_string(profile,
+            MTK_PROVISION_GROUP_PROVISION, keys[i], NULL);
+
+        if (value) {
+            mtk_provision_add(self, MTK_PROVISION_GROUP_PROVISION, keys[i],
+                -1, value);
+            g_free(value);
+        }
+    }
+    g_strfreev(keys);
+
+    g_key_file_unref(profile);
+    self->profile = NULL;
+    DBG("%u provisioning value(s) to send", self->queue->len);
+    mtk_provision_pump(self);
+}
+
+static
+void
+mtk_provision_cfg_loaded(
+    MtkImsCfg* cfg,
+    void* user_data)
+{
+    MtkProvision* self = user_data;
+
+    mtk_ims_cfg_set_loaded_func(cfg, NULL, NULL);
+    mtk_provision_start(self);
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+MtkProvision*
+mtk_provision_new(
+    MtkRadioExt* radio,
+    MtkImsCfg* cfg,
+    const char* cache_file)
+{
+    MtkProvision* self = g_new0(MtkProvision, 1);
+
+    self->radio = mtk_radio_ext_ref(radio);
+    self->cfg = cfg;
+    self->cache_file = g_strdup(cache_file);
+    self->cache = g_key_file_new();
+    self->queue = g_ptr_array_new_with_free_func(mtk_provision_item_free);
+
+    /* It's fine if it's not there yet */
+    g_key_file_load_from_file(self->cache, cache_file, G_KEY_FILE_NONE, NULL);
+    return self;
+}
+
+void
+mtk_provision_free(
+    MtkProvision* self)
+{
+    if (self) {
+        mtk_provision_cancel(self);
+        mtk_radio_ext_unref(self->radio);
+        g_ptr_array_free(self->queue, TRUE);
+        g_key_file_unref(self->cache);
+        g_free(self->cache_file);
+        g_free(self);
+    }
+}
+
+gboolean
+mtk_provision_apply(
+    MtkProvision* self,
+    const char* file,
+    MtkProvisionDoneFunc done,
+    void* user_data)
+{
+    if (G_LIKELY(self) && G_LIKELY(file)) {
+        GKeyFile* profile = g_key_file_new();
+        GError* error = NULL;
+
+        if (!g_key_file_load_from_file(profile, file, G_KEY_FILE_NONE,
+            &error)) {
+            ofono_warn("Failed to load %s: %s", file, error->message);
+            g_error_free(error);
+            g_key_file_unref(profile);
+            return FALSE;
+        }
+
+        mtk_provision_cancel(self);
+        self->profile = profile;
+        self->done = done;
+        self->done_data = user_data;
+
+        /* Diff against the modem's values once they have been read */
+        if (self->cfg && !mtk_ims_cfg_loaded(self->cfg) &&
+            g_key_file_has_group(profile, MTK_PROVISION_GROUP_IMS_CFG)) {
+            DBG("Waiting for the IMS config");
+            mtk_ims_cfg_set_loaded_func(self->cfg, mtk_provision_cfg_loaded,
+                self);
+        } else {
+            mtk_provision_start(self);
+        }
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
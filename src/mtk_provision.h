@@ -0,0 +1,81 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#ifndef MTK_PROVISION_H
+#define MTK_PROVISION_H
+
+#include <glib.h>
+
+/*
+ * Bulk IMS provisioning from a key file:
+ *
+ *   [ImsCfg]
+ *   7=1000         - setImsCfgProvisionValue, ImsConfig id => value
+ *
+ *   [Provision]
+ *   name=value     - setProvisionValue
+ *
+ * Only the values which differ from the modem's config (or, if it's not
+ * known, from what has been successfully applied before) are sent, with
+ * a few requests in flight at a time. Applied values are saved to the
+ * cache file, so applying the same profile again does nothing.
+ */
+
+typedef struct mtk_provision MtkProvision;
+typedef struct mtk_radio_ext MtkRadioExt;
+typedef struct mtk_ims_cfg MtkImsCfg;
+
+/* sent is the number of requests, failed is how many of them failed */
+typedef void (*MtkProvisionDoneFunc)(
+    MtkProvision* provision,
+    guint sent,
+    guint failed,
+    void* user_data);
+
+MtkProvision*
+mtk_provision_new(
+    MtkRadioExt* radio,
+    MtkImsCfg* cfg,
+    const char* cache_file)
+    G_GNUC_INTERNAL;
+
+/* The pending apply is cancelled without completion */
+void
+mtk_provision_free(
+    MtkProvision* provision)
+    G_GNUC_INTERNAL;
+
+/*
+ * Cancels the pending apply if there is one. Returns FALSE if the file
+ * can't be loaded, otherwise done is called exactly once (possibly before
+ * this function returns).
+ */
+gboolean
+mtk_provision_apply(
+    MtkProvision* provision,
+    const char* file,
+    MtkProvisionDoneFunc done,
+    void* user_data)
+    G_GNUC_INTERNAL;
+
+#endif /* MTK_PROVISION_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -20,6 +20,7 @@
 
 #include "mtk_radio_ext.h"
 #include "mtk_radio_ext_types.h"
+#include "mtk_ims_reg.h"
 #include "binder_util.h"
 
 #include <ofono/log.h>
@@ -31,6 +32,8 @@
 #include <gutil_log.h>
 #include <gutil_macros.h>
 
+#include <string.h>
+
 #define MTK_RADIO_CALL_TIMEOUT (3*1000) /* ms */
 
 typedef GObjectClass MtkRadioExtClass;
@@ -45,6 +48,16 @@ typedef struct mtk_radio_ext {
     GBinderLocalObject* mtk_indication;
     GUtilIdlePool* pool;
     GHashTable* requests;
+    GBinderLocalRequest* call_ind_req;
+    MtkRadioExtIncomingCallFilterFunc call_filter;
+    void* call_filter_data;
+    MtkRadioExtLatency incoming_call_latency;
+    guint ims_services[CALL_RAT_COUNT]; /* CALL_RAT_UNKNOWN is any RAT */
+    guint pending_ims_services[CALL_RAT_COUNT];
+    guint ims_services_id; /* Debounces the loss of services */
+    MTK_RADIO_EXT_VOPS vops;
+    MtkRadioExtAckStats ack_stats;
+    GHashTable* unhandled_mtk_ind; /* code => count */
 } MtkRadioExt;
 
 GType mtk_radio_ext_get_type() G_GNUC_INTERNAL;
@@ -58,13 +71,37 @@ G_DEFINE_TYPE(MtkRadioExt, mtk_radio_ext, G_TYPE_OBJECT)
 enum mtk_radio_ext_signal {
     SIGNAL_IMS_REG_STATUS_CHANGED,
     SIGNAL_IMS_REGISTRATION_INFO_CHANGED,
+    SIGNAL_IMS_REG_INFO,
     SIGNAL_CALL_INFO,
+    SIGNAL_ECONF_RESULT,
+    SIGNAL_EVENT_PACKAGE,
+    SIGNAL_INCOMING_CALL,
+    SIGNAL_CALL_RAT,
+    SIGNAL_SPEECH_CODEC,
+    SIGNAL_VOPS_CHANGED,
+    SIGNAL_SSAC_STATUS,
+    SIGNAL_SIP_EVENT,
+    SIGNAL_IMS_CFG_CHANGED,
+    SIGNAL_IMS_CFG_LOADED,
+    SIGNAL_MTK_INDICATION,
     SIGNAL_COUNT
 };
 
 #define SIGNAL_IMS_REG_STATUS_CHANGED_NAME        "mtk-radio-ext-ims-reg-status-changed"
 #define SIGNAL_IMS_REGISTRATION_INFO_CHANGED_NAME "mtk-radio-ext-ims-registration-info-changed"
+#define SIGNAL_IMS_REG_INFO_NAME                  "mtk-radio-ext-ims-reg-info"
 #define SIGNAL_CALL_INFO_NAME                     "mtk-radio-ext-call-info"
+#define SIGNAL_ECONF_RESULT_NAME                  "mtk-radio-ext-econf-result"
+#define SIGNAL_EVENT_PACKAGE_NAME                 "mtk-radio-ext-event-package"
+#define SIGNAL_INCOMING_CALL_NAME                 "mtk-radio-ext-incoming-call"
+#define SIGNAL_CALL_RAT_NAME                      "mtk-radio-ext-call-rat"
+#define SIGNAL_SPEECH_CODEC_NAME                  "mtk-radio-ext-speech-codec"
+#define SIGNAL_VOPS_CHANGED_NAME                  "mtk-radio-ext-vops-changed"
+#define SIGNAL_SSAC_STATUS_NAME                   "mtk-radio-ext-ssac-status"
+#define SIGNAL_SIP_EVENT_NAME                     "mtk-radio-ext-sip-event"
+#define SIGNAL_IMS_CFG_CHANGED_NAME               "mtk-radio-ext-ims-cfg-changed"
+#define SIGNAL_IMS_CFG_LOADED_NAME                "mtk-radio-ext-ims-cfg-loaded"
+#define SIGNAL_MTK_INDICATION_NAME                "mtk-radio-ext-mtk-indication"
 
 static guint mtk_radio_ext_signals[SIGNAL_COUNT] = { 0 };
 
@@ -100,6 +137,11 @@ typedef struct mtk_radio_ext_result_request {
     MtkRadioExtResultFunc complete;
 } MtkRadioExtResultRequest;
 
+typedef struct mtk_radio_ext_ims_cfg_request {
+    MtkRadioExtResultRequest result;
+    int config_id;
+} MtkRadioExtImsCfgRequest;
+
 static GLogModule mtk_radio_ext_binder_log_module = {
     .max_level = GLOG_LEVEL_VERBOSE,
     .level = GLOG_LEVEL_VERBOSE,
@@ -161,6 +203,8 @@ mtk_radio_ext_req_name(
         case MTK_RADIO_REQ_##NAME: return #name;
     MTK_RADIO_EXT_IMS_CALL_3_0(MTK_RADIO_REQ_)
 #undef MTK_RADIO_REQ_
+    case MTK_RADIO_REQ_RESPONSE_ACKNOWLEDGEMENT_MTK:
+        return "responseAcknowledgementMtk";
     }
     return NULL;
 }
@@ -191,6 +235,19 @@ mtk_radio_ext_ind_name(
     return NULL;
 }
 
+static const char*
+mtk_radio_ext_mtk_ind_name(
+    guint32 ind)
+{
+    switch (ind) {
+#define MTK_RADIO_MTK_IND_(code, name, NAME) \
+        case MTK_RADIO_MTK_IND_##NAME: return #name;
+    MTK_RADIO_MTK_INDICATION_3_0(MTK_RADIO_MTK_IND_)
+#undef MTK_RADIO_MTK_IND_
+    }
+    return NULL;
+}
+
 static
 void
 mtk_radio_ext_log_req(
@@ -239,6 +296,7 @@ static
 void
 mtk_radio_ext_log_ind(
     MtkRadioExt* self,
+    const char* iface,
     guint32 code)
 {
     static const GLogModule* log = &mtk_radio_ext_binder_log_module;
@@ -248,12 +306,51 @@ mtk_radio_ext_log_ind(
     if (!gutil_log_enabled(log, level))
         return;
 
-    name = mtk_radio_ext_ind_name(code);
+    name = g_str_equal(iface, MTK_RADIO_MTK_INDICATION) ?
+        mtk_radio_ext_mtk_ind_name(code) :
+        mtk_radio_ext_ind_name(code);
 
     gutil_log(log, level, "%s > %u %s", self->slot, code,
         name ? name : "???");
 }
 
+/*
+ * Hex encodes the whole buffer in one pass and then logs it 16 bytes
+ * per line, followed by the printable characters like gutil_log_dump()
+ * does. Much cheaper than formatting byte by byte.
+ */
+static
+void
+mtk_radio_ext_log_dump(
+    const GLogModule* log,
+    int level,
+    const guint8* data,
+    gsize size)
+{
+    char buf[513];
+    char* hex = (size * 2 < sizeof(buf)) ? buf : g_malloc(size * 2 + 1);
+    gsize off;
+
+    binder_hex_encode(data, size, hex, TRUE);
+    for (off = 0; off < size; off += 16) {
+        const guint n = (guint) MIN(size - off, 16);
+        char ascii[17];
+        guint i;
+
+        for (i = 0; i < n; i++) {
+            const guint8 c = data[off + i];
+
+            ascii[i] = g_ascii_isprint(c) ? (char) c : '.';
+        }
+        ascii[n] = 0;
+        gutil_log(log, level, "  %04x: %-32.*s  %s", (guint) off,
+            (int) n * 2, hex + off * 2, ascii);
+    }
+    if (hex != buf) {
+        g_free(hex);
+    }
+}
+
 static
 void
 mtk_radio_ext_dump_data(
@@ -268,7 +365,7 @@ mtk_radio_ext_dump_data(
         return;
 
     data = gbinder_reader_get_data(reader, &size);
-    gutil_log_dump(log, level, "  ",  data, size);
+    mtk_radio_ext_log_dump(log, level, data, size);
 }
 
 static
@@ -288,7 +385,7 @@ mtk_radio_ext_dump_request(
     /* Use writer API to fetch the raw data */
     gbinder_local_request_init_writer(args, &writer);
     data = gbinder_writer_get_data(&writer, &size);
-    gutil_log_dump(log, level, "  ", data, size);
+    mtk_radio_ext_log_dump(log, level, data, size);
 }
 
 static
@@ -312,31 +409,35 @@ mtk_radio_ext_call(
 #define MAYBE_HIDL_STRING(hstr) ((hstr).data.str ? (hstr).data.str : "")
 
 static
-const IncomingCallNotification*
-mtk_radio_ext_read_incoming_call_notification(
-    MtkRadioExt* self,
-    const GBinderReader* args)
-{
-    GBinderReader reader;
-    const IncomingCallNotification* notification;
+gint32
+mtk_radio_ext_parse_hidl_int(
+    const GBinderHidlString* str)
+{
+    /* Same as atoi() but doesn't need NUL termination */
+    const char* ptr = str->data.str;
+    const char* end = ptr ? (ptr + str->len) : NULL;
+    gboolean neg = FALSE;
+    guint32 val = 0;
+
+    while (ptr < end && g_ascii_isspace(*ptr)) ptr++;
+    if (ptr < end && (*ptr == '-' || *ptr == '+')) {
+        neg = (*ptr++ == '-');
+    }
+    while (ptr < end && g_ascii_isdigit(*ptr)) {
+        val = val * 10 + (*ptr++ - '0');
+    }
+    return neg ? -(gint32)val : (gint32)val;
+}
 
-    gbinder_reader_copy(&reader, args);
-    notification = gbinder_reader_read_hidl_struct(&reader, IncomingCallNotification);
-    if (notification) {
-        DBG("%s: IncomingCallNotification callId:%s number:%s type:%s\n"
-            "callMode:%s seqNo:%s redirectNumber:%s toNumber:%s",
-            self->slot,
-            MAYBE_HIDL_STRING(notification->callId),
-            MAYBE_HIDL_STRING(notification->number),
-            MAYBE_HIDL_STRING(notification->type),
-            MAYBE_HIDL_STRING(notification->callMode),
-            MAYBE_HIDL_STRING(notification->seqNo),
-            MAYBE_HIDL_STRING(notification->redirectNumber),
-            MAYBE_HIDL_STRING(notification->toNumber));
-        return notification;
-    } else {
-        DBG("%s: failed to parse IncomingCallNotification", self->slot);
-        return NULL;
+static
+void
+mtk_radio_ext_prepare_call_indication(
+    MtkRadioExt* self)
+{
+    /* Interface header is written here, out of the incoming call path */
+    if (!self->call_ind_req) {
+        self->call_ind_req = gbinder_client_new_request2(self->client,
+            MTK_RADIO_REQ_SET_CALL_INDICATION);
     }
 }
 
@@ -344,30 +445,81 @@ static
 void
 mtk_radio_ext_handle_incoming_call_indication(
     MtkRadioExt* self,
-    const GBinderReader* args)
+    const GBinderReader* args,
+    gint64 received)
 {
     /* incomingCallIndication(RadioIndicationType type, IncomingCallNotification inCallNotify) */
-    const IncomingCallNotification* notification =
-        mtk_radio_ext_read_incoming_call_notification(self, args);
+    const IncomingCallNotification* notification;
+    GBinderReader reader;
+    guint type;
 
-    if (notification) {
+    gbinder_reader_copy(&reader, args);
+    if (gbinder_reader_read_uint32(&reader, &type) &&
+        (notification = gbinder_reader_read_hidl_struct(&reader,
+        IncomingCallNotification)) != NULL) {
         /* Allow incoming call via setCallIndication */
         /* setCallIndication(int32_t serial, int32_t mode, int32_t callId, int32_t seqNumber, int32_t cause) */
         const guint code = MTK_RADIO_REQ_SET_CALL_INDICATION;
-        GBinderClient* client = self->client;
-        GBinderLocalRequest* req = gbinder_client_new_request2(client, code);
+        const guint serial = mtk_radio_ext_new_req_id();
+        gboolean allow = TRUE;
+        int cause = -1; /* unknown */
+        GBinderLocalRequest* req;
         GBinderWriter writer;
-        guint serial = mtk_radio_ext_new_req_id();
+        gint64 latency;
+
+        if (self->call_filter) {
+            allow = self->call_filter(self,
+                MAYBE_HIDL_STRING(notification->number), &cause,
+                self->call_filter_data);
+        }
+
+        mtk_radio_ext_prepare_call_indication(self);
+        req = self->call_ind_req;
+        self->call_ind_req = NULL;
 
         gbinder_local_request_init_writer(req, &writer);
         gbinder_writer_append_int32(&writer, serial); /* serial */
-        gbinder_writer_append_int32(&writer, IMS_ALLOW_INCOMING_CALL_INDICATION); /* mode */
-        gbinder_writer_append_int32(&writer, atoi(MAYBE_HIDL_STRING(notification->callId))); /* callId */
-        gbinder_writer_append_int32(&writer, atoi(MAYBE_HIDL_STRING(notification->seqNo))); /* seqNumber */
-        gbinder_writer_append_int32(&writer, -1); /* cause = unknown? */
-
-        mtk_radio_ext_call(self, code, serial, req, NULL, NULL, NULL);
+        gbinder_writer_append_int32(&writer, allow ?
+            IMS_ALLOW_INCOMING_CALL_INDICATION :
+            IMS_DISALLOW_INCOMING_CALL_INDICATION); /* mode */
+        gbinder_writer_append_int32(&writer, mtk_radio_ext_parse_hidl_int(&notification->callId)); /* callId */
+        gbinder_writer_append_int32(&writer, mtk_radio_ext_parse_hidl_int(&notification->seqNo)); /* seqNumber */
+        gbinder_writer_append_int32(&writer, allow ? -1 : cause); /* cause */
+        gbinder_client_transact(self->client, code, GBINDER_TX_FLAG_ONEWAY,
+            req, NULL, NULL, NULL);
+
+        /* The call has been allowed, everything else can wait */
+        latency = g_get_monotonic_time() - received;
+        mtk_radio_ext_latency_add(&self->incoming_call_latency, latency);
+        mtk_radio_ext_log_req(self, code, serial);
+        mtk_radio_ext_dump_request(req);
         gbinder_local_request_unref(req);
+
+        /* Transaction is asynchronous, the next call needs a new request */
+        mtk_radio_ext_prepare_call_indication(self);
+
+        DBG("%s: IncomingCallNotification callId:%s number:%s type:%s\n"
+            "callMode:%s seqNo:%s redirectNumber:%s toNumber:%s",
+            self->slot,
+            MAYBE_HIDL_STRING(notification->callId),
+            MAYBE_HIDL_STRING(notification->number),
+            MAYBE_HIDL_STRING(notification->type),
+            MAYBE_HIDL_STRING(notification->callMode),
+            MAYBE_HIDL_STRING(notification->seqNo),
+            MAYBE_HIDL_STRING(notification->redirectNumber),
+            MAYBE_HIDL_STRING(notification->toNumber));
+        if (allow) {
+            DBG("%s: call allowed in %" G_GINT64_FORMAT " us", self->slot,
+                latency);
+        } else {
+            DBG("%s: call rejected (cause %d) in %" G_GINT64_FORMAT " us",
+                self->slot, cause, latency);
+        }
+        g_signal_emit(self, mtk_radio_ext_signals[SIGNAL_INCOMING_CALL], 0,
+            mtk_radio_ext_parse_hidl_int(&notification->callId), allow,
+            received);
+    } else {
+        DBG("%s: failed to parse IncomingCallNotification", self->slot);
     }
 }
 
@@ -384,7 +536,7 @@ mtk_radio_ext_handle_call_info_indication(
     gbinder_reader_copy(&reader, args);
     data = gbinder_reader_read_hidl_string_vec(&reader);
 
-    if (data && g_strv_length(data) >= 6) {
+    if (data && g_strv_length(data) >= 7) {
         /* +ECPI:<call_id>, <msg_type>, <is_ibt>, <is_tch>,
          *       <dir>, <call_mode>, <number>, <toa>, [<cause>] */
 
@@ -393,17 +545,120 @@ mtk_radio_ext_handle_call_info_indication(
         guint msg_type = atoi(data[1]);
         guint call_mode = atoi(data[5]);
         char* number = data[6];
+        int cause = (data[7] && data[8] && data[8][0]) ? atoi(data[8]) : -1;
 
-        DBG("%s: callInfoIndication callId:%d msgType:%d callMode:%d number:%s",
-            self->slot, call_id, msg_type, call_mode, number);
+        DBG("%s: callInfoIndication callId:%d msgType:%d callMode:%d "
+            "number:%s cause:%d", self->slot, call_id, msg_type, call_mode,
+            number, cause);
 
         g_signal_emit(self, mtk_radio_ext_signals[SIGNAL_CALL_INFO],
-                      0, call_id, msg_type, call_mode, number);
-
-        g_strfreev(data);
+                      0, call_id, msg_type, call_mode, number, cause);
     } else {
         DBG("%s: failed to parse callInfoIndication data", self->slot);
     }
+    g_strfreev(data);
+}
+
+static
+void
+mtk_radio_ext_handle_econf_result_indication(
+    MtkRadioExt* self,
+    const GBinderReader* args)
+{
+    /* econfResultIndication(RadioIndicationType type, string confCallId,
+     *     string op, string num, string result, string cause,
+     *     string joinedCallId) */
+    GBinderReader reader;
+    const char* conf_call_id;
+    const char* op;
+    const char* num;
+    const char* result;
+    const char* cause;
+    const char* joined_call_id;
+
+    gbinder_reader_copy(&reader, args);
+    conf_call_id = gbinder_reader_read_hidl_string_c(&reader);
+    op = gbinder_reader_read_hidl_string_c(&reader);
+    num = gbinder_reader_read_hidl_string_c(&reader);
+    result = gbinder_reader_read_hidl_string_c(&reader);
+    cause = gbinder_reader_read_hidl_string_c(&reader);
+    joined_call_id = gbinder_reader_read_hidl_string_c(&reader);
+
+    if (conf_call_id && op && num && result && cause) {
+        DBG("%s: econfResultIndication confCallId:%s op:%s num:%s "
+            "result:%s cause:%s joinedCallId:%s", self->slot, conf_call_id,
+            op, num, result, cause, joined_call_id ? joined_call_id : "");
+
+        g_signal_emit(self, mtk_radio_ext_signals[SIGNAL_ECONF_RESULT], 0,
+            atoi(conf_call_id), atoi(op), num, atoi(result), atoi(cause),
+            joined_call_id ? atoi(joined_call_id) : 0);
+    } else {
+        DBG("%s: failed to parse econfResultIndication", self->slot);
+    }
+}
+
+static
+void
+mtk_radio_ext_handle_ims_event_package_indication(
+    MtkRadioExt* self,
+    const GBinderReader* args)
+{
+    /* imsEventPackageIndication(RadioIndicationType type, string callId,
+     *     string pType, string urcIdx, string totalUrcCount,
+     *     string rawData) */
+    GBinderReader reader;
+    const char* call_id;
+    const char* type;
+    const char* index;
+    const char* count;
+    const char* data;
+
+    gbinder_reader_copy(&reader, args);
+    call_id = gbinder_reader_read_hidl_string_c(&reader);
+    type = gbinder_reader_read_hidl_string_c(&reader);
+    index = gbinder_reader_read_hidl_string_c(&reader);
+    count = gbinder_reader_read_hidl_string_c(&reader);
+    data = gbinder_reader_read_hidl_string_c(&reader);
+
+    if (call_id && type && index && count && data) {
+        /* The payload can be large, don't log it */
+        DBG("%s: imsEventPackageIndication callId:%s type:%s %s/%s, "
+            "%u bytes", self->slot, call_id, type, index, count,
+            (guint) strlen(data));
+
+        g_signal_emit(self, mtk_radio_ext_signals[SIGNAL_EVENT_PACKAGE], 0,
+            atoi(call_id), atoi(type), atoi(index), atoi(count), data);
+    } else {
+        DBG("%s: failed to parse imsEventPackageIndication", self->slot);
+    }
+}
+
+static
+void
+mtk_radio_ext_handle_redial_emergency_indication(
+    MtkRadioExt* self,
+    const GBinderReader* args)
+{
+    /* imsRedialEmergencyIndication(RadioIndicationType type,
+     *     string callId) */
+    GBinderReader reader;
+    const char* call_id;
+
+    gbinder_reader_copy(&reader, args);
+    call_id = gbinder_reader_read_hidl_string_c(&reader);
+
+    /*
+     * The modem asks whether to redial an emergency call over CS.
+     * There's nothing for the user to decide, approve it right away.
+     */
+    if (call_id) {
+        DBG("%s: imsRedialEmergencyIndication callId:%s", self->slot,
+            call_id);
+        mtk_radio_ext_ecc_redial_approve(self, TRUE, atoi(call_id),
+            NULL, NULL, NULL);
+    } else {
+        DBG("%s: failed to parse imsRedialEmergencyIndication", self->slot);
+    }
 }
 
 static
@@ -445,8 +700,89 @@ mtk_radio_ext_handle_ims_reg_status_report(
     const ImsRegStatusInfo* info =
         mtk_radio_ext_read_ims_reg_status_info(self, args);
 
-    g_signal_emit(self, mtk_radio_ext_signals[SIGNAL_IMS_REG_STATUS_CHANGED],
-                    0, info->report_type);
+    if (info) {
+        g_signal_emit(self,
+            mtk_radio_ext_signals[SIGNAL_IMS_REG_STATUS_CHANGED],
+            0, info->report_type);
+    }
+}
+
+static
+void
+mtk_radio_ext_commit_ims_services(
+    MtkRadioExt* self)
+{
+    const guint* services = self->pending_ims_services;
+
+    if (memcmp(self->ims_services, services, sizeof(self->ims_services))) {
+        DBG("%s: IMS services 0x%02x, LTE 0x%02x, Wi-Fi 0x%02x", self->slot,
+            services[CALL_RAT_UNKNOWN], services[CALL_RAT_LTE],
+            services[CALL_RAT_WIFI]);
+        memcpy(self->ims_services, services, sizeof(self->ims_services));
+    }
+}
+
+static
+gboolean
+mtk_radio_ext_ims_services_timeout(
+    gpointer user_data)
+{
+    MtkRadioExt* self = THIS(user_data);
+
+    self->ims_services_id = 0;
+    mtk_radio_ext_commit_ims_services(self);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+mtk_radio_ext_update_ims_services(
+    MtkRadioExt* self,
+    gboolean registered,
+    int caps)
+{
+    guint lte = 0, wifi = 0, any = 0;
+
+    if (registered) {
+        if (caps & IMS_REG_CAP_VOICE_OVER_LTE) {
+            lte |= MTK_RADIO_EXT_IMS_SERVICE_VOICE;
+        }
+        if (caps & IMS_REG_CAP_SMS_OVER_LTE) {
+            lte |= MTK_RADIO_EXT_IMS_SERVICE_SMS;
+        }
+        if (caps & IMS_REG_CAP_VIDEO_OVER_LTE) {
+            lte |= MTK_RADIO_EXT_IMS_SERVICE_VIDEO;
+        }
+        if (caps & IMS_REG_CAP_VOICE_OVER_WIFI) {
+            /* There's no separate bit for SMS over Wi-Fi */
+            wifi |= MTK_RADIO_EXT_IMS_SERVICE_VOICE |
+                MTK_RADIO_EXT_IMS_SERVICE_SMS;
+        }
+        any = lte | wifi;
+        if (!caps) {
+            /* No extended info, don't rule anything out */
+            any = MTK_RADIO_EXT_IMS_SERVICE_ALL;
+        }
+    }
+
+    self->pending_ims_services[CALL_RAT_LTE] = lte;
+    self->pending_ims_services[CALL_RAT_WIFI] = wifi;
+    self->pending_ims_services[CALL_RAT_UNKNOWN] = any;
+    if ((self->ims_services[CALL_RAT_LTE] & ~lte) ||
+        (self->ims_services[CALL_RAT_WIFI] & ~wifi) ||
+        (self->ims_services[CALL_RAT_UNKNOWN] & ~any)) {
+        /* Losing services is debounced like the registration state */
+        if (!self->ims_services_id) {
+            self->ims_services_id = g_timeout_add(MTK_IMS_REG_DEBOUNCE_MS,
+                mtk_radio_ext_ims_services_timeout, self);
+        }
+    } else {
+        if (self->ims_services_id) {
+            g_source_remove(self->ims_services_id);
+            self->ims_services_id = 0;
+        }
+        mtk_radio_ext_commit_ims_services(self);
+    }
 }
 
 static
@@ -467,6 +803,8 @@ mtk_radio_ext_handle_ims_registration_info(
     DBG("%s: IMS Registration info (imsRegistrationInfo): register state: %d, capability: %d",
         self->slot, register_state, capability);
 
+    mtk_radio_ext_update_ims_services(self, register_state != 0, capability);
+
     g_signal_emit(self, mtk_radio_ext_signals[SIGNAL_IMS_REGISTRATION_INFO_CHANGED],
                     0, register_state, capability);
 }
@@ -489,12 +827,18 @@ mtk_radio_ext_handle_speech_codec_info_indication(
 {
     GBinderReader reader;
     int info = 0;
+    SpeechCodec codec;
 
     /* speechCodecInfoIndication(RadioIndicationType type, int32_t info) */
     gbinder_reader_copy(&reader, args);
     gbinder_reader_read_int32(&reader, &info);
+    codec = (info > SPEECH_CODEC_UNKNOWN && info <= SPEECH_CODEC_EVS_FB) ?
+        (SpeechCodec) info : SPEECH_CODEC_UNKNOWN;
 
-    DBG("%s: Speech codec info (speechCodecInfoIndication): %d", self->slot, info);
+    DBG("%s: Speech codec info (speechCodecInfoIndication): %d (%s, %u Hz)",
+        self->slot, info, mtk_radio_ext_speech_codec_name(codec),
+        mtk_radio_ext_speech_codec_sample_rate(codec));
+    g_signal_emit(self, mtk_radio_ext_signals[SIGNAL_SPEECH_CODEC], 0, codec);
 }
 
 static
@@ -533,6 +877,10 @@ mtk_radio_ext_handle_ims_cfg_config_changed(
 
     DBG("%s: IMS Config changed (imsCfgConfigChanged): phone id: %d, config id: %s, value: %s",
         self->slot, phone_id, config_id, value);
+    if (config_id && value) {
+        g_signal_emit(self, mtk_radio_ext_signals[SIGNAL_IMS_CFG_CHANGED], 0,
+            g_intern_string(config_id), value);
+    }
 }
 
 static
@@ -543,6 +891,7 @@ mtk_radio_ext_handle_ims_cfg_config_loaded(
 {
     /* imsCfgConfigLoaded(RadioIndicationType type) */
     DBG("%s: IMS Config loaded (imsCfgConfigLoaded)", self->slot);
+    g_signal_emit(self, mtk_radio_ext_signals[SIGNAL_IMS_CFG_LOADED], 0);
 }
 
 static
@@ -576,21 +925,33 @@ mtk_radio_ext_handle_sip_reg_info_ind(
          * 2. SIP_msg_type
          * 3. method
          * 4. reason_phrase
-         * 5. warn_text */
+         * 5. warn_text (optional) */
 
         char* direction = data[0];
         char* msg_type = data[1];
         char* method = data[2];
         char* reason_phrase = data[3];
         char* warn_text = data[4];
+        MtkRadioExtSipEvent event;
 
         DBG("%s: SIP Registration info indication (sipRegInfoInd):"
             " account id: %d, response code: %d, direction: %s, msg type: %s, method: %s, reason phrase: %s, warn text: %s",
-            self->slot, account_id, response_code, direction, msg_type, method, reason_phrase, warn_text);
-        g_strfreev(data);
+            self->slot, account_id, response_code, direction, msg_type, method, reason_phrase,
+            warn_text ? warn_text : "");
+
+        event.source = MTK_RADIO_EXT_SIP_EVENT_REGISTRATION;
+        event.id = account_id;
+        event.incoming = (atoi(direction) == 1);
+        event.response = (atoi(msg_type) == 1);
+        event.code = response_code;
+        event.method = method;
+        event.reason = reason_phrase;
+        g_signal_emit(self, mtk_radio_ext_signals[SIGNAL_SIP_EVENT], 0,
+            &event);
     } else {
         DBG("%s: failed to parse sipRegInfoInd data", self->slot);
     }
+    g_strfreev(data);
 }
 
 static
@@ -607,7 +968,7 @@ mtk_radio_ext_handle_ims_reg_info_ind(
     gbinder_reader_copy(&reader, args);
     data = gbinder_reader_read_hidl_vec(&reader, &count, &size);
 
-    if (data) {
+    if (data && size == sizeof(*data) && count >= 7) {
         /* 1. reg_state
          * 2. reg_type
          * 3. ext_info
@@ -615,24 +976,77 @@ mtk_radio_ext_handle_ims_reg_info_ind(
          * 5. ims_retry
          * 6. rat
          * 7. sip_uri_type */
-        int reg_state = 0, reg_type = 0, ext_info = 0, dereg_cause = 0, ims_retry = 0, rat = 0, sip_uri_type = 0;
+        MtkRadioExtImsRegInfo info;
 
-        reg_state = data[0];
-        reg_type = data[1];
-        ext_info = data[2];
-        dereg_cause = data[3];
-        ims_retry = data[4];
-        rat = data[5];
-        sip_uri_type = data[6];
+        info.reg_state = data[0];
+        info.reg_type = data[1];
+        info.ext_info = data[2];
+        info.dereg_cause = data[3];
+        info.ims_retry = data[4];
+        info.rat = data[5];
+        info.sip_uri_type = data[6];
 
         DBG("%s: IMS registration info indication (imsRegInfoInd):"
             " reg state: %d, reg type: %d, ext info: %d, dereg cause: %d, ims retry: %d, rat: %d, sip uri type: %d",
-            self->slot, reg_state, reg_type, ext_info, dereg_cause, ims_retry, rat, sip_uri_type);
+            self->slot, info.reg_state, info.reg_type, info.ext_info,
+            info.dereg_cause, info.ims_retry, info.rat, info.sip_uri_type);
+
+        /* Other reg_state values are transient */
+        if (info.reg_state == 0 || info.reg_state == 1) {
+            mtk_radio_ext_update_ims_services(self, info.reg_state,
+                info.ext_info);
+        }
+
+        g_signal_emit(self, mtk_radio_ext_signals[SIGNAL_IMS_REG_INFO], 0,
+            &info);
     } else {
         DBG("%s: failed to parse imsRegInfoInd data", self->slot);
     }
 }
 
+static
+gboolean
+mtk_radio_ext_read_ssac_status(
+    const GBinderReader* args,
+    MtkRadioExtSsacStatus* status)
+{
+    GBinderReader reader;
+    gsize count = 0, size = 0;
+    const int32_t *data;
+
+    /* vec<int32_t> as +ESSAC reports it */
+    gbinder_reader_copy(&reader, args);
+    data = gbinder_reader_read_hidl_vec(&reader, &count, &size);
+    if (data && size == sizeof(*data) && count >= 4) {
+        status->voice_factor = data[0];
+        status->voice_time = data[1];
+        status->video_factor = data[2];
+        status->video_time = data[3];
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static
+void
+mtk_radio_ext_handle_on_ssac_status(
+    MtkRadioExt* self,
+    const GBinderReader* args)
+{
+    MtkRadioExtSsacStatus status;
+
+    /* onSsacStatus(RadioIndicationType type, vec<int32_t> status) */
+    if (mtk_radio_ext_read_ssac_status(args, &status)) {
+        DBG("%s: SSAC status (onSsacStatus): voice %d%% %ds, video %d%% %ds",
+            self->slot, status.voice_factor, status.voice_time,
+            status.video_factor, status.video_time);
+        g_signal_emit(self, mtk_radio_ext_signals[SIGNAL_SSAC_STATUS], 0,
+            &status);
+    } else {
+        DBG("%s: failed to parse onSsacStatus", self->slot);
+    }
+}
+
 static
 void
 mtk_radio_ext_handle_rtt_capability_indication(
@@ -657,6 +1071,22 @@ mtk_radio_ext_handle_rtt_capability_indication(
          self->slot, call_id, local_cap, remote_cap, local_status, remote_status);
 }
 
+static
+void
+mtk_radio_ext_update_vops(
+    MtkRadioExt* self,
+    int vops)
+{
+    const MTK_RADIO_EXT_VOPS value = vops ? MTK_RADIO_EXT_VOPS_SUPPORTED :
+        MTK_RADIO_EXT_VOPS_NOT_SUPPORTED;
+
+    if (self->vops != value) {
+        self->vops = value;
+        g_signal_emit(self, mtk_radio_ext_signals[SIGNAL_VOPS_CHANGED], 0,
+            value);
+    }
+}
+
 static
 void
 mtk_radio_ext_handle_send_vops_indication(
@@ -669,9 +1099,11 @@ mtk_radio_ext_handle_send_vops_indication(
 
     /* sendVopsIndication(RadioIndicationType type, int32_t vops) */
     gbinder_reader_copy(&reader, args);
-    gbinder_reader_read_int32(&reader, &vops);
-
-    DBG("%s: VoPS Indication (sendVopsIndication): VoPS: %d", self->slot, vops);
+    if (gbinder_reader_read_int32(&reader, &vops)) {
+        DBG("%s: VoPS Indication (sendVopsIndication): VoPS: %d",
+            self->slot, vops);
+        mtk_radio_ext_update_vops(self, vops);
+    }
 }
 
 static
@@ -695,6 +1127,20 @@ mtk_radio_ext_handle_sip_call_progress_indicator(
     DBG("%s: SIP Call progress indicator (sipCallProgressIndicator): call id: %s, dir: %s,"
         " SIP message type: %s, method: %s, response code: %s, reason text: %s",
         self->slot, call_id, dir, sip_msg_type, method, response_code, reason_text);
+
+    if (call_id && dir && sip_msg_type && method) {
+        MtkRadioExtSipEvent event;
+
+        event.source = MTK_RADIO_EXT_SIP_EVENT_CALL;
+        event.id = atoi(call_id);
+        event.incoming = (atoi(dir) == 1);
+        event.response = (atoi(sip_msg_type) == 1);
+        event.code = response_code ? atoi(response_code) : 0;
+        event.method = method;
+        event.reason = reason_text;
+        g_signal_emit(self, mtk_radio_ext_signals[SIGNAL_SIP_EVENT], 0,
+            &event);
+    }
 }
 
 static
@@ -767,8 +1213,83 @@ mtk_radio_ext_handle_call_rat_indication(
     gbinder_reader_read_int32(&reader, &rat);
 
     DBG("%s: Call RAT (callRatIndication): domain: %d (%s), rat: %d (%s)", self->slot,
-        domain, domain == 0 ? "CS" : (domain == 1 ? "IMS" : "Unknown"),
-        rat, rat == 1 ? "LTE" : (rat == 2 ? "Wifi" : "Unknown"));
+        domain, domain == CALL_RAT_DOMAIN_CS ? "CS" :
+        (domain == CALL_RAT_DOMAIN_IMS ? "IMS" : "Unknown"),
+        rat, rat == CALL_RAT_LTE ? "LTE" :
+        (rat == CALL_RAT_WIFI ? "Wifi" : "Unknown"));
+    if (rat < CALL_RAT_UNKNOWN || rat >= CALL_RAT_COUNT) {
+        rat = CALL_RAT_UNKNOWN;
+    }
+    g_signal_emit(self, mtk_radio_ext_signals[SIGNAL_CALL_RAT], 0,
+        domain, rat);
+}
+
+static
+void
+mtk_radio_ext_ack(
+    MtkRadioExt* self,
+    const GBinderReader* args)
+{
+    GBinderReader reader;
+    guint type;
+
+    /* All indications start with RadioIndicationType */
+    gbinder_reader_copy(&reader, args);
+    if (gbinder_reader_read_uint32(&reader, &type) &&
+        type == RADIO_IND_ACK_EXP) {
+        MtkRadioExtAckStats* stats = &self->ack_stats;
+        GBinderLocalRequest* req = gbinder_client_new_request2(self->client,
+            MTK_RADIO_REQ_RESPONSE_ACKNOWLEDGEMENT_MTK);
+
+        /*
+         * responseAcknowledgementMtk has no arguments, the RIL releases
+         * its wakelock once per call. Send it right away, a oneway
+         * transaction doesn't wait for the RIL.
+         */
+        stats->expected++;
+        mtk_radio_ext_log_req(self, MTK_RADIO_REQ_RESPONSE_ACKNOWLEDGEMENT_MTK,
+            0);
+        if (gbinder_client_transact_sync_oneway(self->client,
+            MTK_RADIO_REQ_RESPONSE_ACKNOWLEDGEMENT_MTK, req) ==
+            GBINDER_STATUS_OK) {
+            stats->acked++;
+        } else {
+            stats->unacked++;
+            DBG("%s: %u/%u unacked", self->slot, stats->unacked,
+                stats->expected);
+        }
+        gbinder_local_request_unref(req);
+    }
+}
+
+static
+GQuark
+mtk_radio_ext_mtk_indication_detail(
+    guint code,
+    gboolean create)
+{
+    char detail[16];
+
+    snprintf(detail, sizeof(detail), "%u", code);
+    return create ? g_quark_from_string(detail) : g_quark_try_string(detail);
+}
+
+static
+gboolean
+mtk_radio_ext_dispatch_mtk_indication(
+    MtkRadioExt* self,
+    guint code,
+    const GBinderReader* args)
+{
+    const guint signal = mtk_radio_ext_signals[SIGNAL_MTK_INDICATION];
+    /* No quark means that nobody has ever subscribed to this code */
+    const GQuark detail = mtk_radio_ext_mtk_indication_detail(code, FALSE);
+
+    if (detail && g_signal_has_handler_pending(self, signal, detail, FALSE)) {
+        g_signal_emit(self, signal, detail, code, args);
+        return TRUE;
+    }
+    return FALSE;
 }
 
 static
@@ -781,24 +1302,42 @@ mtk_radio_ext_indication(
     int* status,
     void* user_data)
 {
+    const gint64 received = g_get_monotonic_time();
     MtkRadioExt* self = THIS(user_data);
     const char* iface = gbinder_remote_request_interface(req);
     GBinderReader args;
 
     gbinder_remote_request_init_reader(req, &args);
-    mtk_radio_ext_log_ind(self, code);
+    if (code == IMS_RADIO_IND_INCOMING_CALL_INDICATION &&
+        g_str_equal(iface, MTK_RADIO_IMS_INDICATION)) {
+        /* Time to ring is user visible, allow the call before the ack */
+        mtk_radio_ext_handle_incoming_call_indication(self, &args, received);
+        mtk_radio_ext_ack(self, &args);
+        mtk_radio_ext_log_ind(self, iface, code);
+        mtk_radio_ext_dump_data(&args);
+        return NULL;
+    }
+
+    mtk_radio_ext_ack(self, &args);
+    mtk_radio_ext_log_ind(self, iface, code);
     mtk_radio_ext_dump_data(&args);
 
     if (g_str_equal(iface, MTK_RADIO_IMS_INDICATION)) {
         guint type;
         if (gbinder_reader_read_uint32(&args, &type)) {
             switch(code) {
-            case IMS_RADIO_IND_INCOMING_CALL_INDICATION:
-                mtk_radio_ext_handle_incoming_call_indication(self, &args);
-                return NULL;
             case IMS_RADIO_IND_CALL_INFO_INDICATION:
                 mtk_radio_ext_handle_call_info_indication(self, &args);
                 return NULL;
+            case IMS_RADIO_IND_ECONF_RESULT_INDICATION:
+                mtk_radio_ext_handle_econf_result_indication(self, &args);
+                return NULL;
+            case IMS_RADIO_IND_IMS_EVENT_PACKAGE_INDICATION:
+                mtk_radio_ext_handle_ims_event_package_indication(self, &args);
+                return NULL;
+            case IMS_RADIO_IND_IMS_REDIAL_EMERGENCY_INDICATION:
+                mtk_radio_ext_handle_redial_emergency_indication(self, &args);
+                return NULL;
             case IMS_RADIO_IND_SIP_CALL_PROGRESS_INDICATOR:
                 mtk_radio_ext_handle_sip_call_progress_indicator(self, &args);
                 return NULL;
@@ -850,25 +1389,33 @@ mtk_radio_ext_indication(
             case IMS_RADIO_IND_IMS_REG_INFO_IND:
                 mtk_radio_ext_handle_ims_reg_info_ind(self, &args);
                 return NULL;
+            case IMS_RADIO_IND_ON_SSAC_STATUS:
+                mtk_radio_ext_handle_on_ssac_status(self, &args);
+                return NULL;
             }
         } else {
             DBG("Failed to decode IMS indication %s %u", iface, code);
             *status = GBINDER_STATUS_FAILED;
         }
-        // TODO: ack type == RADIO_IND_ACK_EXP indications
     } else if (g_str_equal(iface, MTK_RADIO_MTK_INDICATION)) {
         guint type;
         if (gbinder_reader_read_uint32(&args, &type)) {
-            switch(code) {
-            default:
-                DBG("Unhandled MTK indication code: %u", code);
-                break;
+            gpointer count;
+
+            if (mtk_radio_ext_dispatch_mtk_indication(self, code, &args)) {
+                return NULL;
             }
+            count = g_hash_table_lookup(self->unhandled_mtk_ind,
+                GUINT_TO_POINTER(code));
+            g_hash_table_insert(self->unhandled_mtk_ind,
+                GUINT_TO_POINTER(code),
+                GUINT_TO_POINTER(GPOINTER_TO_UINT(count) + 1));
+            DBG("Unhandled MTK indication code: %u", code);
         } else {
             DBG("Failed to decode MTK indication %s %u", iface, code);
             *status = GBINDER_STATUS_FAILED;
         }
-        // TODO: ack type == RADIO_IND_ACK_EXP indications
+        return NULL;
     }
 
     DBG("Unexpected indication %s %u", iface, code);
@@ -902,7 +1449,12 @@ mtk_radio_ext_response(
         MtkRadioExtRequest* req = g_hash_table_lookup(self->requests,
             KEY(info->serial));
 
-        if (req && req->response_code == code) {
+        /*
+         * Requests submitted with zero response code match any response
+         * with their serial. That's for the ones answered through
+         * IMtkRadioExResponse with codes which aren't in our tables.
+         */
+        if (req && (req->response_code == code || !req->response_code)) {
             g_object_ref(self);
             if (req->handle_response) {
                 req->handle_response(req, info, &reader);
@@ -994,14 +1546,14 @@ MtkRadioExtResultRequest*
 mtk_radio_ext_result_request_new(
     MtkRadioExt* self,
     gint32 resp,
+    MtkRadioExtRequestHandlerFunc handler,
     MtkRadioExtResultFunc complete,
     GDestroyNotify destroy,
     void* user_data)
 {
     MtkRadioExtResultRequest* req =
         (MtkRadioExtResultRequest*)mtk_radio_ext_request_alloc(self, resp,
-            mtk_radio_ext_result_response, destroy, user_data,
-            sizeof(MtkRadioExtResultRequest));
+            handler, destroy, user_data, sizeof(MtkRadioExtResultRequest));
 
     req->complete = complete;
     return req;
@@ -1047,7 +1599,7 @@ mtk_radio_ext_result_request_submit(
         GBinderWriter writer;
         MtkRadioExtResultRequest* req =
             mtk_radio_ext_result_request_new(self, resp_code,
-                complete, destroy, user_data);
+                mtk_radio_ext_result_response, complete, destroy, user_data);
         const guint req_id = req->base.id;
 
         args = gbinder_client_new_request2(self->client, req_code);
@@ -1128,79 +1680,178 @@ mtk_radio_ext_create(
     DBG("setResponseFunctionsMtk status %d", status);
     gbinder_local_request_unref(mtk_req);
 
-    return self;
-}
-
-/* Taken and modified from ofono-binder-plugin's binder_sms.c */
-
-static
-void
-mtk_ims_sms_gsm_message(
-    GBinderWriter* writer,
-    RadioGsmSmsMessage* msg,
-    const unsigned char* pdu,
-    int pdu_len,
-    int tpdu_len,
-    const GBinderParent* parent)
-{
-    char* tpdu;
-    int smsc_len = pdu_len - tpdu_len;
-    guint msg_index;
-
-    binder_copy_hidl_string(writer, &msg->smscPdu, NULL);
-
-    /* PDU is sent as an ASCII hex string */
-    msg->pdu.len = tpdu_len * 2;
-    tpdu = gbinder_writer_malloc(writer, msg->pdu.len + 1);
-    ofono_encode_hex(pdu + smsc_len, tpdu_len, tpdu);
-    msg->pdu.data.str = tpdu;
-    DBG("PDU: %s", tpdu);
+    mtk_radio_ext_prepare_call_indication(self);
 
-    /* Write GsmSmsMessage and its strings */
-    msg_index = gbinder_writer_append_buffer_object_with_parent(writer,
-        msg, sizeof(*msg), parent);
-    binder_append_hidl_string_data(writer, msg, smscPdu, msg_index);
-    binder_append_hidl_string_data(writer, msg, pdu, msg_index);
+    return self;
 }
 
+/*
+ * Writes RadioImsSmsMessage with a single RadioGsmSmsMessage. Both
+ * structures and both hex strings share one writer allocation, see
+ * binder_ims_gsm_sms_init().
+ */
 static
 void
-mtk_ims_sms_ims_message(
+mtk_radio_ext_write_ims_sms(
     GBinderWriter* writer,
-    const unsigned char* pdu,
-    int pdu_len,
-    int tpdu_len)
+    const guint8* pdu,
+    gsize pdu_len)
 {
-    RadioImsSmsMessage* ims = gbinder_writer_new0(writer, RadioImsSmsMessage);
-    RadioGsmSmsMessage* gsm = gbinder_writer_new0(writer, RadioGsmSmsMessage);
+    void* buf = gbinder_writer_malloc0(writer,
+        binder_ims_gsm_sms_size(pdu, pdu_len));
+    RadioImsSmsMessage* ims = binder_ims_gsm_sms_init(buf, pdu, pdu_len);
+    RadioGsmSmsMessage* gsm = ims->gsmMessage.data.ptr;
     GBinderParent p;
+    guint gsm_index;
 
-    ims->tech = RADIO_TECH_FAMILY_3GPP2;
-    ims->gsmMessage.count = 1;
-    ims->gsmMessage.data.ptr = gsm;
-    ims->gsmMessage.owns_buffer = TRUE;
+    DBG("SMSC %u, TPDU %u hex digit(s)", (guint) gsm->smscPdu.len,
+        (guint) gsm->pdu.len);
 
     p.index = gbinder_writer_append_buffer_object(writer, ims, sizeof(*ims));
     p.offset = G_STRUCT_OFFSET(RadioImsSmsMessage, cdmaMessage.data.ptr);
     gbinder_writer_append_buffer_object_with_parent(writer, NULL, 0, &p);
 
+    /* Write GsmSmsMessage and its strings */
     p.offset = G_STRUCT_OFFSET(RadioImsSmsMessage, gsmMessage.data.ptr);
-    mtk_ims_sms_gsm_message(writer, gsm, pdu, pdu_len, tpdu_len, &p);
+    gsm_index = gbinder_writer_append_buffer_object_with_parent(writer,
+        gsm, sizeof(*gsm), &p);
+    binder_append_hidl_string_data(writer, gsm, smscPdu, gsm_index);
+    binder_append_hidl_string_data(writer, gsm, pdu, gsm_index);
 }
 
 /*==========================================================================*
  * API
  *==========================================================================*/
 
-MtkRadioExt*
-mtk_radio_ext_new(
-    const char* dev,
-    const char* slot)
+void
+mtk_radio_ext_set_incoming_call_filter(
+    MtkRadioExt* self,
+    MtkRadioExtIncomingCallFilterFunc filter,
+    void* user_data)
 {
-    MtkRadioExt* self = NULL;
-    GBinderServiceManager* sm = gbinder_servicemanager_new(dev);
-
-    if (sm) {
+    if (G_LIKELY(self)) {
+        self->call_filter = filter;
+        self->call_filter_data = user_data;
+    }
+}
+
+void
+mtk_radio_ext_latency_add(
+    MtkRadioExtLatency* latency,
+    gint64 us)
+{
+    latency->count++;
+    latency->last = us;
+    latency->total += us;
+    if (latency->max < us) {
+        latency->max = us;
+    }
+}
+
+guint
+mtk_radio_ext_speech_codec_sample_rate(
+    SpeechCodec codec)
+{
+    switch (codec) {
+    case SPEECH_CODEC_AMR:
+    case SPEECH_CODEC_QCELP13K:
+    case SPEECH_CODEC_EVRC:
+    case SPEECH_CODEC_EVRC_B:
+    case SPEECH_CODEC_GSM_EFR:
+    case SPEECH_CODEC_GSM_FR:
+    case SPEECH_CODEC_GSM_HR:
+    case SPEECH_CODEC_G711U:
+    case SPEECH_CODEC_G723:
+    case SPEECH_CODEC_G711A:
+    case SPEECH_CODEC_G711AB:
+    case SPEECH_CODEC_G729:
+    case SPEECH_CODEC_EVS_NB:
+        return 8000;
+    case SPEECH_CODEC_AMR_WB:
+    case SPEECH_CODEC_EVRC_WB:
+    case SPEECH_CODEC_EVRC_NW:
+    case SPEECH_CODEC_G722:
+    case SPEECH_CODEC_EVS_WB:
+        return 16000;
+    case SPEECH_CODEC_EVS_SWB:
+        return 32000;
+    case SPEECH_CODEC_EVS_FB:
+        return 48000;
+    case SPEECH_CODEC_UNKNOWN:
+        break;
+    }
+    return 0;
+}
+
+const char*
+mtk_radio_ext_speech_codec_name(
+    SpeechCodec codec)
+{
+    static const char* names[] = {
+        "unknown", "AMR", "AMR-WB", "QCELP13K", "EVRC", "EVRC-B",
+        "EVRC-WB", "EVRC-NW", "GSM-EFR", "GSM-FR", "GSM-HR", "G711U",
+        "G723", "G711A", "G722", "G711AB", "G729", "EVS-NB", "EVS-WB",
+        "EVS-SWB", "EVS-FB"
+    };
+
+    return ((guint)codec < G_N_ELEMENTS(names)) ? names[codec] : names[0];
+}
+
+const MtkRadioExtLatency*
+mtk_radio_ext_incoming_call_latency(
+    MtkRadioExt* self)
+{
+    return G_LIKELY(self) ? &self->incoming_call_latency : NULL;
+}
+
+const MtkRadioExtAckStats*
+mtk_radio_ext_ack_stats(
+    MtkRadioExt* self)
+{
+    return G_LIKELY(self) ? &self->ack_stats : NULL;
+}
+
+guint
+mtk_radio_ext_ims_services(
+    MtkRadioExt* self,
+    CallRat rat)
+{
+    return (G_LIKELY(self) && (guint)rat < CALL_RAT_COUNT) ?
+        self->ims_services[rat] : 0;
+}
+
+gboolean
+mtk_radio_ext_ims_service_available(
+    MtkRadioExt* self,
+    MTK_RADIO_EXT_IMS_SERVICE service)
+{
+    if (G_LIKELY(self) &&
+        (self->ims_services[CALL_RAT_UNKNOWN] & service) == service) {
+        /* Without VoPS voice can only go over Wi-Fi */
+        return !(service & MTK_RADIO_EXT_IMS_SERVICE_VOICE) ||
+            self->vops != MTK_RADIO_EXT_VOPS_NOT_SUPPORTED ||
+            (self->ims_services[CALL_RAT_WIFI] &
+                MTK_RADIO_EXT_IMS_SERVICE_VOICE);
+    }
+    return FALSE;
+}
+
+MTK_RADIO_EXT_VOPS
+mtk_radio_ext_vops(
+    MtkRadioExt* self)
+{
+    return G_LIKELY(self) ? self->vops : MTK_RADIO_EXT_VOPS_UNKNOWN;
+}
+
+MtkRadioExt*
+mtk_radio_ext_new(
+    const char* dev,
+    const char* slot)
+{
+    MtkRadioExt* self = NULL;
+    GBinderServiceManager* sm = gbinder_servicemanager_new(dev);
+
+    if (sm) {
         char* fqname = g_strconcat(MTK_RADIO, "/", slot, NULL);
         GBinderRemoteObject* obj = /* autoreleased */
             gbinder_servicemanager_get_service_sync(sm, fqname, NULL);
@@ -1257,6 +1908,243 @@ mtk_radio_ext_set_enabled_args(
     gbinder_writer_append_bool(args, va_arg(va, gboolean));
 }
 
+static
+void
+mtk_radio_ext_query_vops_status_response(
+    MtkRadioExtRequest* req,
+    const RadioResponseInfo* info,
+    const GBinderReader* args)
+{
+    /* queryVopsStatusResponse(RadioResponseInfo info, int32_t vops) */
+    if (info->error == RADIO_ERROR_NONE) {
+        GBinderReader reader;
+        gint32 vops;
+
+        gbinder_reader_copy(&reader, args);
+        if (gbinder_reader_read_int32(&reader, &vops)) {
+            DBG("%s: VoPS: %d", req->radio->slot, vops);
+            mtk_radio_ext_update_vops(req->radio, vops);
+        }
+    }
+    mtk_radio_ext_result_response(req, info, args);
+}
+
+guint
+mtk_radio_ext_query_vops_status(
+    MtkRadioExt* self,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data)
+{
+    if (G_LIKELY(self)) {
+        const guint code = MTK_RADIO_REQ_QUERY_VOPS_STATUS;
+        GBinderLocalRequest* args =
+            gbinder_client_new_request2(self->client, code);
+        GBinderWriter writer;
+        /* queryVopsStatusResponse comes through IMtkRadioExResponse */
+        MtkRadioExtResultRequest* req =
+            mtk_radio_ext_result_request_new(self, 0,
+                mtk_radio_ext_query_vops_status_response,
+                complete, destroy, user_data);
+        const guint req_id = req->base.id;
+
+        /* queryVopsStatus(int32_t serial) */
+        gbinder_local_request_init_writer(args, &writer);
+        gbinder_writer_append_int32(&writer, req_id);
+
+        /* Submit the request */
+        mtk_radio_ext_submit_request(&req->base, code, req_id, args);
+        gbinder_local_request_unref(args);
+        if (req->base.tx) {
+            /* Success */
+            return req_id;
+        }
+        g_hash_table_remove(self->requests, KEY(req_id));
+    }
+    return 0;
+}
+
+static
+void
+mtk_radio_ext_query_ssac_status_response(
+    MtkRadioExtRequest* req,
+    const RadioResponseInfo* info,
+    const GBinderReader* args)
+{
+    MtkRadioExt* self = req->radio;
+    MtkRadioExtSsacStatus status;
+
+    /* querySsacStatusResponse(RadioResponseInfo info, vec<int32_t> status) */
+    if (info->error == RADIO_ERROR_NONE &&
+        mtk_radio_ext_read_ssac_status(args, &status)) {
+        DBG("%s: SSAC status: voice %d%% %ds, video %d%% %ds", self->slot,
+            status.voice_factor, status.voice_time, status.video_factor,
+            status.video_time);
+        g_signal_emit(self, mtk_radio_ext_signals[SIGNAL_SSAC_STATUS], 0,
+            &status);
+    }
+    mtk_radio_ext_result_response(req, info, args);
+}
+
+guint
+mtk_radio_ext_query_ssac_status(
+    MtkRadioExt* self,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data)
+{
+    if (G_LIKELY(self)) {
+        const guint code = MTK_RADIO_REQ_QUERY_SSAC_STATUS;
+        GBinderLocalRequest* args =
+            gbinder_client_new_request2(self->client, code);
+        GBinderWriter writer;
+        /* querySsacStatusResponse comes through IMtkRadioExResponse */
+        MtkRadioExtResultRequest* req =
+            mtk_radio_ext_result_request_new(self, 0,
+                mtk_radio_ext_query_ssac_status_response,
+                complete, destroy, user_data);
+        const guint req_id = req->base.id;
+
+        /* querySsacStatus(int32_t serial) */
+        gbinder_local_request_init_writer(args, &writer);
+        gbinder_writer_append_int32(&writer, req_id);
+
+        /* Submit the request */
+        mtk_radio_ext_submit_request(&req->base, code, req_id, args);
+        gbinder_local_request_unref(args);
+        if (req->base.tx) {
+            /* Success */
+            return req_id;
+        }
+        g_hash_table_remove(self->requests, KEY(req_id));
+    }
+    return 0;
+}
+
+static
+void
+mtk_radio_ext_get_ims_cfg_provision_value_response(
+    MtkRadioExtRequest* req,
+    const RadioResponseInfo* info,
+    const GBinderReader* args)
+{
+    MtkRadioExt* self = req->radio;
+    MtkRadioExtImsCfgRequest* cfg_req = G_CAST(req,
+        MtkRadioExtImsCfgRequest, result.base);
+
+    /* getImsCfgProvisionValueResponse(RadioResponseInfo info, string value) */
+    if (info->error == RADIO_ERROR_NONE) {
+        GBinderReader reader;
+        const char* value;
+
+        gbinder_reader_copy(&reader, args);
+        value = gbinder_reader_read_hidl_string_c(&reader);
+        if (value) {
+            char buf[16];
+
+            snprintf(buf, sizeof(buf), "%d", cfg_req->config_id);
+            DBG("%s: IMS config %s: %s", self->slot, buf, value);
+            g_signal_emit(self, mtk_radio_ext_signals[SIGNAL_IMS_CFG_CHANGED],
+                0, g_intern_string(buf), value);
+        }
+    }
+    mtk_radio_ext_result_response(req, info, args);
+}
+
+guint
+mtk_radio_ext_get_ims_cfg_provision_value(
+    MtkRadioExt* self,
+    int config_id,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data)
+{
+    if (G_LIKELY(self)) {
+        const guint code = MTK_RADIO_REQ_GET_IMS_CFG_PROVISION_VALUE;
+        GBinderLocalRequest* args =
+            gbinder_client_new_request2(self->client, code);
+        GBinderWriter writer;
+        MtkRadioExtImsCfgRequest* req = mtk_radio_ext_request_alloc(self, 0,
+            mtk_radio_ext_get_ims_cfg_provision_value_response, destroy,
+            user_data, sizeof(MtkRadioExtImsCfgRequest));
+        const guint req_id = req->result.base.id;
+
+        req->result.complete = complete;
+        req->config_id = config_id;
+
+        /* getImsCfgProvisionValue(int32_t serial, int32_t configId) */
+        gbinder_local_request_init_writer(args, &writer);
+        gbinder_writer_append_int32(&writer, req_id);
+        gbinder_writer_append_int32(&writer, config_id);
+
+        /* Submit the request */
+        mtk_radio_ext_submit_request(&req->result.base, code, req_id, args);
+        gbinder_local_request_unref(args);
+        if (req->result.base.tx) {
+            /* Success */
+            return req_id;
+        }
+        g_hash_table_remove(self->requests, KEY(req_id));
+    }
+    return 0;
+}
+
+static
+void
+mtk_radio_ext_set_ims_cfg_provision_value_args(
+    GBinderWriter* args,
+    va_list va)
+{
+    // configId
+    gbinder_writer_append_int32(args, va_arg(va, int));
+    // value
+    gbinder_writer_append_hidl_string_copy(args, va_arg(va, const char*));
+}
+
+guint
+mtk_radio_ext_set_ims_cfg_provision_value(
+    MtkRadioExt* self,
+    int config_id,
+    const char* value,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data)
+{
+    return mtk_radio_ext_result_request_submit(self,
+        MTK_RADIO_REQ_SET_IMS_CFG_PROVISION_VALUE, 0,
+        mtk_radio_ext_set_ims_cfg_provision_value_args,
+        complete, destroy, user_data,
+        config_id, value);
+}
+
+static
+void
+mtk_radio_ext_set_provision_value_args(
+    GBinderWriter* args,
+    va_list va)
+{
+    // provisionstring
+    gbinder_writer_append_hidl_string_copy(args, va_arg(va, const char*));
+    // provisionValue
+    gbinder_writer_append_hidl_string_copy(args, va_arg(va, const char*));
+}
+
+guint
+mtk_radio_ext_set_provision_value(
+    MtkRadioExt* self,
+    const char* key,
+    const char* value,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data)
+{
+    return mtk_radio_ext_result_request_submit(self,
+        MTK_RADIO_REQ_SET_PROVISION_VALUE, 0,
+        mtk_radio_ext_set_provision_value_args,
+        complete, destroy, user_data,
+        key, value);
+}
+
 guint
 mtk_radio_ext_set_enabled(
     MtkRadioExt* self,
@@ -1478,6 +2366,185 @@ mtk_radio_ext_hangup_all(
         complete, destroy, user_data);
 }
 
+static
+void
+mtk_radio_ext_control_call_args(
+    GBinderWriter* args,
+    va_list va)
+{
+    // controlType
+    gbinder_writer_append_int32(args, va_arg(va, guint32));
+    // callId
+    gbinder_writer_append_int32(args, va_arg(va, guint32));
+}
+
+guint
+mtk_radio_ext_control_call(
+    MtkRadioExt* self,
+    guint control_type,
+    guint call_id,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data)
+{
+    return mtk_radio_ext_result_request_submit(self,
+        MTK_RADIO_REQ_CONTROL_CALL,
+        IMS_RADIO_RESP_CONTROL_CALL,
+        mtk_radio_ext_control_call_args,
+        complete, destroy, user_data,
+        control_type, call_id);
+}
+
+static
+void
+mtk_radio_ext_dial_with_sip_uri_args(
+    GBinderWriter* args,
+    va_list va)
+{
+    // address
+    gbinder_writer_append_hidl_string(args, va_arg(va, const char*));
+}
+
+guint
+mtk_radio_ext_dial_with_sip_uri(
+    MtkRadioExt* self,
+    const char* address,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data)
+{
+    return mtk_radio_ext_result_request_submit(self,
+        MTK_RADIO_REQ_DIAL_WITH_SIP_URI, 0,
+        mtk_radio_ext_dial_with_sip_uri_args,
+        complete, destroy, user_data,
+        address);
+}
+
+static
+void
+mtk_radio_ext_set_ecc_mode_args(
+    GBinderWriter* args,
+    va_list va)
+{
+    // number
+    gbinder_writer_append_hidl_string(args, va_arg(va, const char*));
+    // enable
+    gbinder_writer_append_int32(args, va_arg(va, gboolean));
+    // airplaneMode
+    gbinder_writer_append_int32(args, va_arg(va, gboolean));
+    // imsReg
+    gbinder_writer_append_int32(args, va_arg(va, gboolean));
+}
+
+guint
+mtk_radio_ext_set_ecc_mode(
+    MtkRadioExt* self,
+    const char* number,
+    gboolean enable,
+    gboolean airplane_mode,
+    gboolean ims_reg,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data)
+{
+    return mtk_radio_ext_result_request_submit(self,
+        MTK_RADIO_REQ_SET_ECC_MODE, 0,
+        mtk_radio_ext_set_ecc_mode_args,
+        complete, destroy, user_data,
+        number, enable, airplane_mode, ims_reg);
+}
+
+static
+void
+mtk_radio_ext_ecc_redial_approve_args(
+    GBinderWriter* args,
+    va_list va)
+{
+    // approve
+    gbinder_writer_append_int32(args, va_arg(va, gboolean));
+    // callId
+    gbinder_writer_append_int32(args, va_arg(va, guint32));
+}
+
+guint
+mtk_radio_ext_ecc_redial_approve(
+    MtkRadioExt* self,
+    gboolean approve,
+    guint call_id,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data)
+{
+    return mtk_radio_ext_result_request_submit(self,
+        MTK_RADIO_REQ_ECC_REDIAL_APPROVE, 0,
+        mtk_radio_ext_ecc_redial_approve_args,
+        complete, destroy, user_data,
+        approve, call_id);
+}
+
+static
+void
+mtk_radio_ext_control_conference_member_args(
+    GBinderWriter* args,
+    va_list va)
+{
+    // controlType
+    gbinder_writer_append_int32(args, va_arg(va, guint32));
+    // confCallId
+    gbinder_writer_append_int32(args, va_arg(va, guint32));
+    // address
+    gbinder_writer_append_hidl_string(args, va_arg(va, const char*));
+    // callId
+    gbinder_writer_append_int32(args, va_arg(va, gint32));
+}
+
+guint
+mtk_radio_ext_control_conference_member(
+    MtkRadioExt* self,
+    guint control_type,
+    guint conf_call_id,
+    const char* address,
+    int call_id,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data)
+{
+    return mtk_radio_ext_result_request_submit(self,
+        MTK_RADIO_REQ_CONTROL_IMS_CONFERENCE_CALL_MEMBER, 0,
+        mtk_radio_ext_control_conference_member_args,
+        complete, destroy, user_data,
+        control_type, conf_call_id, address, call_id);
+}
+
+static
+void
+mtk_radio_ext_hangup_with_reason_args(
+    GBinderWriter* args,
+    va_list va)
+{
+    // callId
+    gbinder_writer_append_int32(args, va_arg(va, guint32));
+    // reason
+    gbinder_writer_append_int32(args, va_arg(va, gint32));
+}
+
+guint
+mtk_radio_ext_hangup_with_reason(
+    MtkRadioExt* self,
+    guint call_id,
+    int reason,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data)
+{
+    return mtk_radio_ext_result_request_submit(self,
+        MTK_RADIO_REQ_HANGUP_WITH_REASON,
+        0, // hangupWithReasonResponse comes through IMtkRadioExResponse
+        mtk_radio_ext_hangup_with_reason_args,
+        complete, destroy, user_data,
+        call_id, reason);
+}
+
 guint
 mtk_radio_ext_send_ims_sms_ex(
     MtkRadioExt* self,
@@ -1496,12 +2563,12 @@ mtk_radio_ext_send_ims_sms_ex(
         GBinderWriter writer;
         MtkRadioExtResultRequest* req =
             mtk_radio_ext_result_request_new(self, resp_code,
-                complete, destroy, user_data);
+                mtk_radio_ext_result_response, complete, destroy, user_data);
         const guint req_id = req->base.id;
 
         gbinder_local_request_init_writer(args, &writer);
         gbinder_writer_append_int32(&writer, req_id);
-        mtk_ims_sms_ims_message(&writer, pdu, pdu_len, pdu_len - (smsc ? strlen(smsc) : 0));
+        mtk_radio_ext_write_ims_sms(&writer, pdu, pdu_len);
 
         /* Submit the request */
         mtk_radio_ext_submit_request(&req->base, code, req_id, args);
@@ -1545,6 +2612,147 @@ mtk_radio_ext_add_call_info_handler(
         SIGNAL_CALL_INFO_NAME, G_CALLBACK(handler), user_data) : 0;
 }
 
+gulong
+mtk_radio_ext_add_econf_result_handler(
+    MtkRadioExt* self,
+    MtkRadioExtEconfResultFunc handler,
+    void* user_data)
+{
+    return (G_LIKELY(self) && G_LIKELY(handler)) ? g_signal_connect(self,
+        SIGNAL_ECONF_RESULT_NAME, G_CALLBACK(handler), user_data) : 0;
+}
+
+gulong
+mtk_radio_ext_add_event_package_handler(
+    MtkRadioExt* self,
+    MtkRadioExtEventPackageFunc handler,
+    void* user_data)
+{
+    return (G_LIKELY(self) && G_LIKELY(handler)) ? g_signal_connect(self,
+        SIGNAL_EVENT_PACKAGE_NAME, G_CALLBACK(handler), user_data) : 0;
+}
+
+gulong
+mtk_radio_ext_add_ims_reg_info_handler(
+    MtkRadioExt* self,
+    MtkRadioExtImsRegInfoFunc handler,
+    void* user_data)
+{
+    return (G_LIKELY(self) && G_LIKELY(handler)) ? g_signal_connect(self,
+        SIGNAL_IMS_REG_INFO_NAME, G_CALLBACK(handler), user_data) : 0;
+}
+
+gulong
+mtk_radio_ext_add_incoming_call_handler(
+    MtkRadioExt* self,
+    MtkRadioExtIncomingCallFunc handler,
+    void* user_data)
+{
+    return (G_LIKELY(self) && G_LIKELY(handler)) ? g_signal_connect(self,
+        SIGNAL_INCOMING_CALL_NAME, G_CALLBACK(handler), user_data) : 0;
+}
+
+gulong
+mtk_radio_ext_add_call_rat_handler(
+    MtkRadioExt* self,
+    MtkRadioExtCallRatFunc handler,
+    void* user_data)
+{
+    return (G_LIKELY(self) && G_LIKELY(handler)) ? g_signal_connect(self,
+        SIGNAL_CALL_RAT_NAME, G_CALLBACK(handler), user_data) : 0;
+}
+
+gulong
+mtk_radio_ext_add_speech_codec_handler(
+    MtkRadioExt* self,
+    MtkRadioExtSpeechCodecFunc handler,
+    void* user_data)
+{
+    return (G_LIKELY(self) && G_LIKELY(handler)) ? g_signal_connect(self,
+        SIGNAL_SPEECH_CODEC_NAME, G_CALLBACK(handler), user_data) : 0;
+}
+
+gulong
+mtk_radio_ext_add_vops_handler(
+    MtkRadioExt* self,
+    MtkRadioExtVopsFunc handler,
+    void* user_data)
+{
+    return (G_LIKELY(self) && G_LIKELY(handler)) ? g_signal_connect(self,
+        SIGNAL_VOPS_CHANGED_NAME, G_CALLBACK(handler), user_data) : 0;
+}
+
+gulong
+mtk_radio_ext_add_sip_event_handler(
+    MtkRadioExt* self,
+    MtkRadioExtSipEventFunc handler,
+    void* user_data)
+{
+    return (G_LIKELY(self) && G_LIKELY(handler)) ? g_signal_connect(self,
+        SIGNAL_SIP_EVENT_NAME, G_CALLBACK(handler), user_data) : 0;
+}
+
+gulong
+mtk_radio_ext_add_ssac_status_handler(
+    MtkRadioExt* self,
+    MtkRadioExtSsacStatusFunc handler,
+    void* user_data)
+{
+    return (G_LIKELY(self) && G_LIKELY(handler)) ? g_signal_connect(self,
+        SIGNAL_SSAC_STATUS_NAME, G_CALLBACK(handler), user_data) : 0;
+}
+
+gulong
+mtk_radio_ext_add_ims_cfg_changed_handler(
+    MtkRadioExt* self,
+    MtkRadioExtImsCfgFunc handler,
+    void* user_data)
+{
+    return (G_LIKELY(self) && G_LIKELY(handler)) ? g_signal_connect(self,
+        SIGNAL_IMS_CFG_CHANGED_NAME, G_CALLBACK(handler), user_data) : 0;
+}
+
+gulong
+mtk_radio_ext_add_ims_cfg_loaded_handler(
+    MtkRadioExt* self,
+    MtkRadioExtFunc handler,
+    void* user_data)
+{
+    return (G_LIKELY(self) && G_LIKELY(handler)) ? g_signal_connect(self,
+        SIGNAL_IMS_CFG_LOADED_NAME, G_CALLBACK(handler), user_data) : 0;
+}
+
+gulong
+mtk_radio_ext_add_mtk_indication_handler(
+    MtkRadioExt* self,
+    guint code,
+    MtkRadioExtMtkIndicationFunc handler,
+    void* user_data)
+{
+    return (G_LIKELY(self) && G_LIKELY(handler)) ?
+        g_signal_connect_closure_by_id(self,
+            mtk_radio_ext_signals[SIGNAL_MTK_INDICATION],
+            mtk_radio_ext_mtk_indication_detail(code, TRUE),
+            g_cclosure_new(G_CALLBACK(handler), user_data, NULL), FALSE) : 0;
+}
+
+void
+mtk_radio_ext_foreach_unhandled_mtk_indication(
+    MtkRadioExt* self,
+    MtkRadioExtCodeCountFunc func,
+    void* user_data)
+{
+    if (G_LIKELY(self) && G_LIKELY(func)) {
+        GHashTableIter it;
+        gpointer key, value;
+
+        g_hash_table_iter_init(&it, self->unhandled_mtk_ind);
+        while (g_hash_table_iter_next(&it, &key, &value)) {
+            func(GPOINTER_TO_UINT(key), GPOINTER_TO_UINT(value), user_data);
+        }
+    }
+}
+
 /*==========================================================================*
  * Internals
  *==========================================================================*/
@@ -1556,6 +2764,11 @@ mtk_radio_ext_finalize(
 {
     MtkRadioExt* self = THIS(object);
 
+    if (self->ims_services_id) {
+        g_source_remove(self->ims_services_id);
+    }
+    gbinder_local_request_unref(self->call_ind_req);
+    g_hash_table_destroy(self->unhandled_mtk_ind);
     g_free(self->slot);
     G_OBJECT_CLASS(PARENT_CLASS)->finalize(object);
 }
@@ -1568,6 +2781,11 @@ mtk_radio_ext_init(
     self->pool = gutil_idle_pool_new();
     self->requests = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
         mtk_radio_ext_request_destroy);
+    self->unhandled_mtk_ind = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+    /* Until the modem tells otherwise */
+    self->ims_services[CALL_RAT_UNKNOWN] = MTK_RADIO_EXT_IMS_SERVICE_ALL;
+    self->vops = MTK_RADIO_EXT_VOPS_UNKNOWN;
 }
 
 static
@@ -1584,10 +2802,62 @@ mtk_radio_ext_class_init(
         g_signal_new(SIGNAL_IMS_REGISTRATION_INFO_CHANGED_NAME, G_OBJECT_CLASS_TYPE(klass),
             G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
             2, G_TYPE_INT, G_TYPE_INT);
+    mtk_radio_ext_signals[SIGNAL_IMS_REG_INFO] =
+        g_signal_new(SIGNAL_IMS_REG_INFO_NAME, G_OBJECT_CLASS_TYPE(klass),
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
+            1, G_TYPE_POINTER);
     mtk_radio_ext_signals[SIGNAL_CALL_INFO] =
         g_signal_new(SIGNAL_CALL_INFO_NAME, G_OBJECT_CLASS_TYPE(klass),
             G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
-            4, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_STRING);
+            5, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_STRING,
+            G_TYPE_INT);
+    mtk_radio_ext_signals[SIGNAL_ECONF_RESULT] =
+        g_signal_new(SIGNAL_ECONF_RESULT_NAME, G_OBJECT_CLASS_TYPE(klass),
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
+            6, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_STRING, G_TYPE_INT,
+            G_TYPE_INT, G_TYPE_UINT);
+    mtk_radio_ext_signals[SIGNAL_EVENT_PACKAGE] =
+        g_signal_new(SIGNAL_EVENT_PACKAGE_NAME, G_OBJECT_CLASS_TYPE(klass),
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
+            5, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT,
+            G_TYPE_STRING);
+    mtk_radio_ext_signals[SIGNAL_INCOMING_CALL] =
+        g_signal_new(SIGNAL_INCOMING_CALL_NAME, G_OBJECT_CLASS_TYPE(klass),
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
+            3, G_TYPE_UINT, G_TYPE_BOOLEAN, G_TYPE_INT64);
+    mtk_radio_ext_signals[SIGNAL_CALL_RAT] =
+        g_signal_new(SIGNAL_CALL_RAT_NAME, G_OBJECT_CLASS_TYPE(klass),
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
+            2, G_TYPE_INT, G_TYPE_INT);
+    mtk_radio_ext_signals[SIGNAL_SPEECH_CODEC] =
+        g_signal_new(SIGNAL_SPEECH_CODEC_NAME, G_OBJECT_CLASS_TYPE(klass),
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
+            1, G_TYPE_INT);
+    mtk_radio_ext_signals[SIGNAL_VOPS_CHANGED] =
+        g_signal_new(SIGNAL_VOPS_CHANGED_NAME, G_OBJECT_CLASS_TYPE(klass),
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
+            1, G_TYPE_INT);
+    mtk_radio_ext_signals[SIGNAL_SSAC_STATUS] =
+        g_signal_new(SIGNAL_SSAC_STATUS_NAME, G_OBJECT_CLASS_TYPE(klass),
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
+            1, G_TYPE_POINTER);
+    mtk_radio_ext_signals[SIGNAL_SIP_EVENT] =
+        g_signal_new(SIGNAL_SIP_EVENT_NAME, G_OBJECT_CLASS_TYPE(klass),
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
+            1, G_TYPE_POINTER);
+    /* Interned config id, hence G_TYPE_POINTER */
+    mtk_radio_ext_signals[SIGNAL_IMS_CFG_CHANGED] =
+        g_signal_new(SIGNAL_IMS_CFG_CHANGED_NAME, G_OBJECT_CLASS_TYPE(klass),
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE,
+            2, G_TYPE_POINTER, G_TYPE_STRING);
+    mtk_radio_ext_signals[SIGNAL_IMS_CFG_LOADED] =
+        g_signal_new(SIGNAL_IMS_CFG_LOADED_NAME, G_OBJECT_CLASS_TYPE(klass),
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL, G_TYPE_NONE, 0);
+    /* Detailed by the indication code */
+    mtk_radio_ext_signals[SIGNAL_MTK_INDICATION] =
+        g_signal_new(SIGNAL_MTK_INDICATION_NAME, G_OBJECT_CLASS_TYPE(klass),
+            G_SIGNAL_RUN_FIRST | G_SIGNAL_DETAILED, 0, NULL, NULL, NULL,
+            G_TYPE_NONE, 2, G_TYPE_UINT, G_TYPE_POINTER);
 }
 
 /*
@@ -22,6 +22,24 @@
 
 typedef struct mtk_radio_ext MtkRadioExt;
 typedef enum call_info_msg_type CallInfoMsgType;
+typedef enum speech_codec SpeechCodec;
+typedef enum call_rat_domain CallRatDomain;
+typedef enum call_rat CallRat;
+
+/* Latency statistics, all times in microseconds */
+typedef struct mtk_radio_ext_latency {
+    guint count;
+    gint64 last;
+    gint64 max;
+    gint64 total;
+} MtkRadioExtLatency;
+
+/* Indications of type RADIO_IND_ACK_EXP */
+typedef struct mtk_radio_ext_ack_stats {
+    guint expected;  /* Indications which asked for an ack */
+    guint acked;     /* Acks sent */
+    guint unacked;   /* Acks which couldn't be sent */
+} MtkRadioExtAckStats;
 
 typedef void (*MtkRadioExtResultFunc)(
     MtkRadioExt* radio,
@@ -39,14 +57,159 @@ typedef void (*MtkRadioExtImsRegistrationInfoFunc)(
     int capability,
     void* user_data);
 
+/* Services registered with IMS */
+typedef enum mtk_radio_ext_ims_service {
+    MTK_RADIO_EXT_IMS_SERVICE_VOICE = 0x01,
+    MTK_RADIO_EXT_IMS_SERVICE_SMS = 0x02,
+    MTK_RADIO_EXT_IMS_SERVICE_VIDEO = 0x04,
+    MTK_RADIO_EXT_IMS_SERVICE_ALL = 0x07
+} MTK_RADIO_EXT_IMS_SERVICE;
+
+/* Voice over PS session support of the serving cell */
+typedef enum mtk_radio_ext_vops {
+    MTK_RADIO_EXT_VOPS_UNKNOWN = -1,
+    MTK_RADIO_EXT_VOPS_NOT_SUPPORTED,
+    MTK_RADIO_EXT_VOPS_SUPPORTED
+} MTK_RADIO_EXT_VOPS;
+
+/* sipRegInfoInd and sipCallProgressIndicator */
+typedef enum mtk_radio_ext_sip_event_source {
+    MTK_RADIO_EXT_SIP_EVENT_REGISTRATION,
+    MTK_RADIO_EXT_SIP_EVENT_CALL
+} MTK_RADIO_EXT_SIP_EVENT_SOURCE;
+
+typedef struct mtk_radio_ext_sip_event {
+    MTK_RADIO_EXT_SIP_EVENT_SOURCE source;
+    int id;           /* Account id or call id */
+    gboolean incoming;
+    gboolean response;
+    int code;         /* Response code */
+    const char* method;
+    const char* reason; /* May be NULL */
+} MtkRadioExtSipEvent;
+
+typedef void (*MtkRadioExtSipEventFunc)(
+    MtkRadioExt* radio,
+    const MtkRadioExtSipEvent* event,
+    void* user_data);
+
+/* onSsacStatus, barring factors in percent and times in seconds */
+typedef struct mtk_radio_ext_ssac_status {
+    int voice_factor;
+    int voice_time;
+    int video_factor;
+    int video_time;
+} MtkRadioExtSsacStatus;
+
+/* imsRegInfoInd, the same fields as +CIREGU */
+typedef struct mtk_radio_ext_ims_reg_info {
+    int reg_state;
+    int reg_type;
+    int ext_info;
+    int dereg_cause;
+    int ims_retry;
+    int rat;
+    int sip_uri_type;
+} MtkRadioExtImsRegInfo;
+
+typedef void (*MtkRadioExtImsRegInfoFunc)(
+    MtkRadioExt* radio,
+    const MtkRadioExtImsRegInfo* info,
+    void* user_data);
+
 typedef void (*MtkRadioExtCallInfoFunc)(
     MtkRadioExt* radio,
     guint call_id,
     CallInfoMsgType msg_type,
     guint call_mode,
     char* number,
+    int cause, /* Disconnect cause or -1 */
+    void* user_data);
+
+/* op is IMS_CONF_MEMBER_ADD or IMS_CONF_MEMBER_REMOVE, result 0 is success */
+typedef void (*MtkRadioExtEconfResultFunc)(
+    MtkRadioExt* radio,
+    guint conf_call_id,
+    guint op,
+    const char* number,
+    int result,
+    int cause,
+    guint joined_call_id,
+    void* user_data);
+
+/* Event package payloads may be split into count pieces, index is 1-based */
+typedef void (*MtkRadioExtEventPackageFunc)(
+    MtkRadioExt* radio,
+    guint call_id,
+    guint type,
+    guint index,
+    guint count,
+    const char* data,
+    void* user_data);
+
+/* Emitted after setCallIndication, received is the monotonic time */
+typedef void (*MtkRadioExtIncomingCallFunc)(
+    MtkRadioExt* radio,
+    guint call_id,
+    gboolean allowed,
+    gint64 received,
+    void* user_data);
+
+typedef void (*MtkRadioExtCallRatFunc)(
+    MtkRadioExt* radio,
+    CallRatDomain domain,
+    CallRat rat,
+    void* user_data);
+
+typedef void (*MtkRadioExtSpeechCodecFunc)(
+    MtkRadioExt* radio,
+    SpeechCodec codec,
+    void* user_data);
+
+typedef void (*MtkRadioExtVopsFunc)(
+    MtkRadioExt* radio,
+    MTK_RADIO_EXT_VOPS vops,
+    void* user_data);
+
+typedef void (*MtkRadioExtSsacStatusFunc)(
+    MtkRadioExt* radio,
+    const MtkRadioExtSsacStatus* status,
+    void* user_data);
+
+/* imsCfgConfigChanged, config_id is interned */
+typedef void (*MtkRadioExtImsCfgFunc)(
+    MtkRadioExt* radio,
+    const char* config_id,
+    const char* value,
+    void* user_data);
+
+typedef void (*MtkRadioExtFunc)(
+    MtkRadioExt* radio,
+    void* user_data);
+
+/* IMtkRadioExIndication, args are positioned after the indication type */
+typedef void (*MtkRadioExtMtkIndicationFunc)(
+    MtkRadioExt* radio,
+    guint code,
+    const GBinderReader* args,
+    void* user_data);
+
+/* Returns FALSE and sets the cause to reject the call at the modem */
+typedef gboolean (*MtkRadioExtIncomingCallFilterFunc)(
+    MtkRadioExt* radio,
+    const char* number,
+    int* cause,
     void* user_data);
 
+/* Audio sample rate in Hz, zero if unknown */
+guint
+mtk_radio_ext_speech_codec_sample_rate(
+    SpeechCodec codec);
+
+const char*
+mtk_radio_ext_speech_codec_name(
+    SpeechCodec codec);
+
 MtkRadioExt*
 mtk_radio_ext_new(
     const char* dev,
@@ -65,6 +228,49 @@ mtk_radio_ext_cancel(
     MtkRadioExt* self,
     guint id);
 
+/* Updates the cached VoPS state before completing */
+guint
+mtk_radio_ext_query_vops_status(
+    MtkRadioExt* self,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data);
+
+/* The result is emitted like onSsacStatus */
+guint
+mtk_radio_ext_query_ssac_status(
+    MtkRadioExt* self,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data);
+
+/* The value is emitted like imsCfgConfigChanged */
+guint
+mtk_radio_ext_get_ims_cfg_provision_value(
+    MtkRadioExt* self,
+    int config_id,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data);
+
+guint
+mtk_radio_ext_set_ims_cfg_provision_value(
+    MtkRadioExt* self,
+    int config_id,
+    const char* value,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data);
+
+guint
+mtk_radio_ext_set_provision_value(
+    MtkRadioExt* self,
+    const char* key,
+    const char* value,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data);
+
 guint
 mtk_radio_ext_set_enabled(
     MtkRadioExt* self,
@@ -127,6 +333,63 @@ mtk_radio_ext_hangup_all(
     GDestroyNotify destroy,
     void* user_data);
 
+guint
+mtk_radio_ext_control_call(
+    MtkRadioExt* self,
+    guint control_type,
+    guint call_id,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data);
+
+guint
+mtk_radio_ext_dial_with_sip_uri(
+    MtkRadioExt* self,
+    const char* address,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data);
+
+guint
+mtk_radio_ext_set_ecc_mode(
+    MtkRadioExt* self,
+    const char* number,
+    gboolean enable,
+    gboolean airplane_mode,
+    gboolean ims_reg,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data);
+
+guint
+mtk_radio_ext_ecc_redial_approve(
+    MtkRadioExt* self,
+    gboolean approve,
+    guint call_id,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data);
+
+guint
+mtk_radio_ext_control_conference_member(
+    MtkRadioExt* self,
+    guint control_type,
+    guint conf_call_id,
+    const char* address,
+    int call_id,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data);
+
+guint
+mtk_radio_ext_hangup_with_reason(
+    MtkRadioExt* self,
+    guint call_id,
+    int reason,
+    MtkRadioExtResultFunc complete,
+    GDestroyNotify destroy,
+    void* user_data);
+
 guint
 mtk_radio_ext_send_ims_sms_ex(
     MtkRadioExt* self,
@@ -137,6 +400,48 @@ mtk_radio_ext_send_ims_sms_ex(
     GDestroyNotify destroy,
     void* user_data);
 
+void
+mtk_radio_ext_set_incoming_call_filter(
+    MtkRadioExt* self,
+    MtkRadioExtIncomingCallFilterFunc filter,
+    void* user_data);
+
+void
+mtk_radio_ext_latency_add(
+    MtkRadioExtLatency* latency,
+    gint64 us);
+
+const MtkRadioExtLatency*
+mtk_radio_ext_incoming_call_latency(
+    MtkRadioExt* self);
+
+const MtkRadioExtAckStats*
+mtk_radio_ext_ack_stats(
+    MtkRadioExt* self);
+
+/*
+ * MTK_RADIO_EXT_IMS_SERVICE bits registered over the RAT, CALL_RAT_UNKNOWN
+ * returns the ones registered over any RAT. Losing a service only shows
+ * after MTK_IMS_REG_DEBOUNCE_MS, like the loss of registration.
+ */
+guint
+mtk_radio_ext_ims_services(
+    MtkRadioExt* self,
+    CallRat rat);
+
+/*
+ * FALSE if the modem has reported that the service isn't registered.
+ * Voice also needs either VoPS or registration over Wi-Fi.
+ */
+gboolean
+mtk_radio_ext_ims_service_available(
+    MtkRadioExt* self,
+    MTK_RADIO_EXT_IMS_SERVICE service);
+
+MTK_RADIO_EXT_VOPS
+mtk_radio_ext_vops(
+    MtkRadioExt* self);
+
 gulong
 mtk_radio_ext_add_ims_reg_status_handler(
     MtkRadioExt* self,
@@ -155,6 +460,93 @@ mtk_radio_ext_add_call_info_handler(
     MtkRadioExtCallInfoFunc handler,
     void* user_data);
 
+gulong
+mtk_radio_ext_add_econf_result_handler(
+    MtkRadioExt* self,
+    MtkRadioExtEconfResultFunc handler,
+    void* user_data);
+
+gulong
+mtk_radio_ext_add_event_package_handler(
+    MtkRadioExt* self,
+    MtkRadioExtEventPackageFunc handler,
+    void* user_data);
+
+gulong
+mtk_radio_ext_add_ims_reg_info_handler(
+    MtkRadioExt* self,
+    MtkRadioExtImsRegInfoFunc handler,
+    void* user_data);
+
+gulong
+mtk_radio_ext_add_incoming_call_handler(
+    MtkRadioExt* self,
+    MtkRadioExtIncomingCallFunc handler,
+    void* user_data);
+
+gulong
+mtk_radio_ext_add_call_rat_handler(
+    MtkRadioExt* self,
+    MtkRadioExtCallRatFunc handler,
+    void* user_data);
+
+gulong
+mtk_radio_ext_add_speech_codec_handler(
+    MtkRadioExt* self,
+    MtkRadioExtSpeechCodecFunc handler,
+    void* user_data);
+
+gulong
+mtk_radio_ext_add_vops_handler(
+    MtkRadioExt* self,
+    MtkRadioExtVopsFunc handler,
+    void* user_data);
+
+gulong
+mtk_radio_ext_add_sip_event_handler(
+    MtkRadioExt* self,
+    MtkRadioExtSipEventFunc handler,
+    void* user_data);
+
+gulong
+mtk_radio_ext_add_ssac_status_handler(
+    MtkRadioExt* self,
+    MtkRadioExtSsacStatusFunc handler,
+    void* user_data);
+
+gulong
+mtk_radio_ext_add_ims_cfg_changed_handler(
+    MtkRadioExt* self,
+    MtkRadioExtImsCfgFunc handler,
+    void* user_data);
+
+/* imsCfgConfigLoaded */
+gulong
+mtk_radio_ext_add_ims_cfg_loaded_handler(
+    MtkRadioExt* self,
+    MtkRadioExtFunc handler,
+    void* user_data);
+
+typedef void (*MtkRadioExtCodeCountFunc)(
+    guint code,
+    guint count,
+    void* user_data);
+
+/* Indications without subscribers aren't decoded at all */
+gulong
+mtk_radio_ext_add_mtk_indication_handler(
+    MtkRadioExt* self,
+    guint code, /* MTK_RADIO_MTK_IND */
+    MtkRadioExtMtkIndicationFunc handler,
+    void* user_data);
+
+/* IMtkRadioExIndication codes which nobody has handled, in no order */
+void
+mtk_radio_ext_foreach_unhandled_mtk_indication(
+    MtkRadioExt* self,
+    MtkRadioExtCodeCountFunc func,
+    void* user_data);
+
 #endif /* MTK_RADIO_EXT_H */
 
 /*
@@ -361,6 +361,67 @@ typedef enum ims_radio_ind {
 #undef IMS_RADIO_IND_
 } IMS_RADIO_IND;
 
+/*
+ * e(code, name, NAME)
+ *
+ * Listing an indication here gives it a name and an MTK_RADIO_MTK_IND
+ * value, it's still only decoded by whoever subscribes to its code.
+ * Codes arriving without a subscriber are counted, see
+ * mtk_radio_ext_foreach_unhandled_mtk_indication()
+ */
+#define MTK_RADIO_MTK_INDICATION_3_0(e) \
+    e(1, cfuStatusNotify, CFU_STATUS_NOTIFY) \
+    e(2, cipherIndication, CIPHER_INDICATION) \
+    e(3, suppSvcNotifyEx, SUPP_SVC_NOTIFY_EX) \
+    e(4, crssIndication, CRSS_INDICATION) \
+    e(5, eccNumIndication, ECC_NUM_INDICATION) \
+    e(6, responseCsNetworkStateChangeInd, RESPONSE_CS_NETWORK_STATE_CHANGE_IND) \
+    e(7, responsePsNetworkStateChangeInd, RESPONSE_PS_NETWORK_STATE_CHANGE_IND) \
+    e(8, responseNetworkEventInd, RESPONSE_NETWORK_EVENT_IND) \
+    e(9, networkRejectEventInd, NETWORK_REJECT_EVENT_IND) \
+    e(10, responseModulationInfoInd, RESPONSE_MODULATION_INFO_IND) \
+    e(11, responseInvalidSimInd, RESPONSE_INVALID_SIM_IND) \
+    e(12, responseFemtocellInfo, RESPONSE_FEMTOCELL_INFO) \
+    e(13, onLteAccessStratumStateChanged, ON_LTE_ACCESS_STRATUM_STATE_CHANGED) \
+    e(14, onImsiRefreshDone, ON_IMSI_REFRESH_DONE) \
+    e(15, onCardDetectedInd, ON_CARD_DETECTED_IND) \
+    e(16, newEtwsInd, NEW_ETWS_IND) \
+    e(17, meSmsStorageFullInd, ME_SMS_STORAGE_FULL_IND) \
+    e(18, smsReadyInd, SMS_READY_IND) \
+    e(19, dataCallListChangedEx, DATA_CALL_LIST_CHANGED_EX) \
+    e(20, dataAllowedNotification, DATA_ALLOWED_NOTIFICATION) \
+    e(21, onPseudoCellInfoInd, ON_PSEUDO_CELL_INFO_IND) \
+    e(22, plmnChangedIndication, PLMN_CHANGED_INDICATION) \
+    e(23, registrationSuspendedIndication, REGISTRATION_SUSPENDED_INDICATION) \
+    e(24, gmssRatChangedIndication, GMSS_RAT_CHANGED_INDICATION) \
+    e(25, worldModeChangedIndication, WORLD_MODE_CHANGED_INDICATION) \
+    e(26, resetAttachApnInd, RESET_ATTACH_APN_IND) \
+    e(27, mdChangedApnInd, MD_CHANGED_APN_IND) \
+    e(28, esnMeidChangeInd, ESN_MEID_CHANGE_IND) \
+    e(29, phbReadyNotification, PHB_READY_NOTIFICATION) \
+    e(30, bipProactiveCommand, BIP_PROACTIVE_COMMAND) \
+    e(31, triggerOtaSP, TRIGGER_OTA_SP) \
+    e(32, onStkMenuReset, ON_STK_MENU_RESET) \
+    e(33, onMdDataRetryCountReset, ON_MD_DATA_RETRY_COUNT_RESET) \
+    e(34, onRemoveRestrictEutran, ON_REMOVE_RESTRICT_EUTRAN) \
+    e(35, onPcoStatus, ON_PCO_STATUS) \
+    e(36, onSimPlugIn, ON_SIM_PLUG_IN) \
+    e(37, onSimPlugOut, ON_SIM_PLUG_OUT) \
+    e(38, onSimMissing, ON_SIM_MISSING) \
+    e(39, onSimRecovery, ON_SIM_RECOVERY) \
+    e(40, onSimTrayPlugIn, ON_SIM_TRAY_PLUG_IN) \
+    e(41, onSimCommonSlotNoChanged, ON_SIM_COMMON_SLOT_NO_CHANGED) \
+    e(42, onSimMeLockEvent, ON_SIM_ME_LOCK_EVENT) \
+    e(43, smlSlotLockInfoChangedInd, SML_SLOT_LOCK_INFO_CHANGED_IND)
+
+typedef enum mtk_radio_mtk_ind {
+    /* vendor.mediatek.hardware.mtkradioex@3.0::IMtkRadioExIndication */
+#define MTK_RADIO_MTK_IND_(code, name, NAME) MTK_RADIO_MTK_IND_##NAME = code,
+    MTK_RADIO_MTK_INDICATION_3_0(MTK_RADIO_MTK_IND_)
+#undef MTK_RADIO_MTK_IND_
+    MTK_RADIO_MTK_IND_NONE = 0 /* Transaction codes start at 1 */
+} MTK_RADIO_MTK_IND;
+
 /* ImsConfig.FeatureConstants in AOSP */
 typedef enum ims_feature_type {
     FEATURE_TYPE_VOICE_OVER_LTE = 0,
@@ -408,6 +469,21 @@ enum incoming_call_indication_mode {
     IMS_DISALLOW_INCOMING_CALL_INDICATION = 1,
 };
 
+/* controlCall controlType */
+typedef enum ims_control_call_type {
+    IMS_CONTROL_CALL_HOLD = 0,
+    IMS_CONTROL_CALL_RESUME = 1,
+} ImsControlCallType;
+
+/* controlImsConferenceCallMember controlType, also econf op */
+typedef enum ims_conf_member_op {
+    IMS_CONF_MEMBER_ADD = 0,
+    IMS_CONF_MEMBER_REMOVE = 1,
+} ImsConfMemberOp;
+
+/* imsEventPackageIndication pType */
+#define IMS_EVENT_PACKAGE_CONFERENCE (1)
+
 typedef enum ims_reg_status_report_type {
     IMS_REGISTERING,
     IMS_REGISTERED,
@@ -426,6 +502,59 @@ typedef enum call_info_msg_type {
     CALL_INFO_MSG_TYPE_REMOTE_RESUME = 136
 } CallInfoMsgType;
 
+/* callRatIndication domain and rat */
+typedef enum call_rat_domain {
+    CALL_RAT_DOMAIN_CS = 0,
+    CALL_RAT_DOMAIN_IMS = 1
+} CallRatDomain;
+
+typedef enum call_rat {
+    CALL_RAT_UNKNOWN = 0,
+    CALL_RAT_LTE = 1,
+    CALL_RAT_WIFI = 2,
+    CALL_RAT_COUNT
+} CallRat;
+
+/*
+ * imsRegistrationInfo capability bits. imsRegInfoInd ext_info uses
+ * the same values (3GPP TS 27.007 +CIREGU).
+ */
+typedef enum ims_reg_capability {
+    IMS_REG_CAP_VOICE_OVER_LTE = 0x01,
+    IMS_REG_CAP_RCS_OVER_LTE = 0x02,
+    IMS_REG_CAP_SMS_OVER_LTE = 0x04,
+    IMS_REG_CAP_VIDEO_OVER_LTE = 0x08,
+    IMS_REG_CAP_VOICE_OVER_WIFI = 0x10
+} ImsRegCapability;
+
+/*
+ * speechCodecInfoIndication info, numbered like AOSP's
+ * ImsStreamMediaProfile AUDIO_QUALITY_* constants
+ */
+typedef enum speech_codec {
+    SPEECH_CODEC_UNKNOWN = 0,
+    SPEECH_CODEC_AMR = 1,
+    SPEECH_CODEC_AMR_WB = 2,
+    SPEECH_CODEC_QCELP13K = 3,
+    SPEECH_CODEC_EVRC = 4,
+    SPEECH_CODEC_EVRC_B = 5,
+    SPEECH_CODEC_EVRC_WB = 6,
+    SPEECH_CODEC_EVRC_NW = 7,
+    SPEECH_CODEC_GSM_EFR = 8,
+    SPEECH_CODEC_GSM_FR = 9,
+    SPEECH_CODEC_GSM_HR = 10,
+    SPEECH_CODEC_G711U = 11,
+    SPEECH_CODEC_G723 = 12,
+    SPEECH_CODEC_G711A = 13,
+    SPEECH_CODEC_G722 = 14,
+    SPEECH_CODEC_G711AB = 15,
+    SPEECH_CODEC_G729 = 16,
+    SPEECH_CODEC_EVS_NB = 17,
+    SPEECH_CODEC_EVS_WB = 18,
+    SPEECH_CODEC_EVS_SWB = 19,
+    SPEECH_CODEC_EVS_FB = 20
+} SpeechCodec;
+
 typedef struct incoming_call_notification {
     GBinderHidlString callId RADIO_ALIGNED(8);
     GBinderHidlString number RADIO_ALIGNED(8);
@@ -0,0 +1,132 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include "mtk_sip_log.h"
+#include "mtk_radio_ext.h"
+#include "binder_util.h"
+
+#include <gutil_misc.h>
+
+#include <string.h>
+
+struct mtk_sip_log {
+    MtkRadioExt* radio;
+    gulong event_id;
+    MtkSipLogEvent* ring;
+    guint size;
+    guint first;
+    guint count;
+    MtkSipLogEventFunc event_func;
+    void* event_data;
+};
+
+static
+void
+mtk_sip_log_event(
+    MtkRadioExt* radio,
+    const MtkRadioExtSipEvent* event,
+    void* user_data)
+{
+    MtkSipLog* log = user_data;
+    MtkSipLogEvent* entry;
+
+    /* Overwrite the oldest event when the ring is full */
+    if (log->count < log->size) {
+        entry = log->ring + (log->first + log->count++) % log->size;
+    } else {
+        entry = log->ring + log->first;
+        log->first = (log->first + 1) % log->size;
+    }
+
+    entry->time = g_get_real_time();
+    entry->source = event->source;
+    entry->id = event->id;
+    entry->incoming = event->incoming;
+    entry->response = event->response;
+    entry->code = event->code;
+    binder_copy_utf8(entry->method, sizeof(entry->method), event->method);
+    binder_copy_utf8(entry->reason, sizeof(entry->reason), event->reason);
+
+    if (log->event_func) {
+        log->event_func(entry, log->event_data);
+    }
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+MtkSipLog*
+mtk_sip_log_new(
+    MtkRadioExt* radio,
+    guint size)
+{
+    MtkSipLog* log = g_new0(MtkSipLog, 1);
+
+    log->radio = mtk_radio_ext_ref(radio);
+    log->event_id = mtk_radio_ext_add_sip_event_handler(radio,
+        mtk_sip_log_event, log);
+    log->size = MAX(size, 1);
+    log->ring = g_new(MtkSipLogEvent, log->size);
+    return log;
+}
+
+void
+mtk_sip_log_free(
+    MtkSipLog* log)
+{
+    if (log) {
+        gutil_disconnect_handlers(log->radio, &log->event_id, 1);
+        mtk_radio_ext_unref(log->radio);
+        g_free(log->ring);
+        g_free(log);
+    }
+}
+
+void
+mtk_sip_log_set_event_func(
+    MtkSipLog* log,
+    MtkSipLogEventFunc func,
+    void* user_data)
+{
+    if (G_LIKELY(log)) {
+        log->event_func = func;
+        log->event_data = user_data;
+    }
+}
+
+guint
+mtk_sip_log_count(
+    MtkSipLog* log)
+{
+    return G_LIKELY(log) ? log->count : 0;
+}
+
+const MtkSipLogEvent*
+mtk_sip_log_get(
+    MtkSipLog* log,
+    guint i)
+{
+    return (G_LIKELY(log) && i < log->count) ?
+        (log->ring + (log->first + i) % log->size) : NULL;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,89 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#ifndef MTK_SIP_LOG_H
+#define MTK_SIP_LOG_H
+
+#include <glib.h>
+
+/*
+ * The most recent SIP registration and call progress events reported
+ * by the modem. Methods and reason phrases come from the network, they
+ * are copied into fixed size buffers (truncated and made valid UTF-8),
+ * so the log never takes more memory than the ring itself.
+ */
+
+typedef struct mtk_sip_log MtkSipLog;
+typedef struct mtk_radio_ext MtkRadioExt;
+
+/* Including the terminator */
+#define MTK_SIP_LOG_METHOD_SIZE (16)
+#define MTK_SIP_LOG_REASON_SIZE (64)
+
+typedef struct mtk_sip_log_event {
+    gint64 time;        /* Wall clock, microseconds */
+    guint source;       /* MTK_RADIO_EXT_SIP_EVENT_SOURCE */
+    int id;             /* Account id or call id */
+    gboolean incoming;
+    gboolean response;
+    int code;           /* Response code */
+    char method[MTK_SIP_LOG_METHOD_SIZE];
+    char reason[MTK_SIP_LOG_REASON_SIZE]; /* Empty if none */
+} MtkSipLogEvent;
+
+typedef void (*MtkSipLogEventFunc)(
+    const MtkSipLogEvent* event,
+    void* user_data);
+
+MtkSipLog*
+mtk_sip_log_new(
+    MtkRadioExt* radio,
+    guint size)
+    G_GNUC_INTERNAL;
+
+void
+mtk_sip_log_free(
+    MtkSipLog* log)
+    G_GNUC_INTERNAL;
+
+/* Called for each new event */
+void
+mtk_sip_log_set_event_func(
+    MtkSipLog* log,
+    MtkSipLogEventFunc func,
+    void* user_data)
+    G_GNUC_INTERNAL;
+
+guint
+mtk_sip_log_count(
+    MtkSipLog* log)
+    G_GNUC_INTERNAL;
+
+/* Zero is the oldest event */
+const MtkSipLogEvent*
+mtk_sip_log_get(
+    MtkSipLog* log,
+    guint i)
+    G_GNUC_INTERNAL;
+
+#endif /* MTK_SIP_LOG_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
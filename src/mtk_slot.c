@@ -36,16 +36,25 @@
  */
 
 #include "mtk_slot.h"
+#include "mtk_call_policy.h"
+#include "mtk_dbus.h"
 #include "mtk_ims.h"
 #include "mtk_ims_call.h"
+#include "mtk_ims_cfg.h"
 #include "mtk_ims_sms.h"
+#include "mtk_provision.h"
 #include "mtk_radio_ext.h"
+#include "mtk_sip_log.h"
 
 #include <binder_ext_slot_impl.h>
 
+#include <ofono/log.h>
+
 #include <radio_client.h>
 #include <radio_instance.h>
 
+#include <stdlib.h>
+
 typedef BinderExtSlotClass MtkSlotClass;
 typedef struct mtk_slot {
     BinderExtSlot parent;
@@ -55,11 +64,28 @@ typedef struct mtk_slot {
     MtkRadioExt* radio_ext;
     RadioInstance* ims_aosp_instance;
     RadioClient* ims_aosp_client;
+    MtkCallPolicy* call_policy;
+    MtkDbus* dbus;
+    MtkSipLog* sip_log;
+    MtkImsCfg* ims_cfg;
+    MtkProvision* provision;
 } MtkSlot;
 
 GType mtk_slot_get_type() G_GNUC_INTERNAL;
 G_DEFINE_TYPE(MtkSlot, mtk_slot, BINDER_EXT_TYPE_SLOT)
 
+/* Slot parameters */
+#define MTK_SLOT_DTMF_PAUSE_CHARS "dtmfPauseChars"
+#define MTK_SLOT_DTMF_PAUSE_DURATION "dtmfPauseDuration" /* ms */
+
+#define MTK_SLOT_IMS_PROVISIONING "imsProvisioning" /* Profile file */
+
+#define MTK_SLOT_SIP_LOG_SIZE (64)
+
+#ifndef MTK_SLOT_PROVISION_CACHE_DIR
+#  define MTK_SLOT_PROVISION_CACHE_DIR "/var/lib/ofono"
+#endif
+
 #define THIS_TYPE mtk_slot_get_type()
 #define THIS(obj) G_TYPE_CHECK_INSTANCE_CAST(obj, THIS_TYPE, MtkSlot)
 #define PARENT_CLASS mtk_slot_parent_class
@@ -73,6 +99,98 @@ mtk_slot_terminate(
         binder_ext_ims_unref(self->ims);
         self->ims = NULL;
     }
+    if (self->call_policy) {
+        mtk_radio_ext_set_incoming_call_filter(self->radio_ext, NULL, NULL);
+        mtk_call_policy_free(self->call_policy);
+        self->call_policy = NULL;
+    }
+    if (self->dbus) {
+        mtk_dbus_free(self->dbus);
+        self->dbus = NULL;
+    }
+    if (self->sip_log) {
+        mtk_sip_log_free(self->sip_log);
+        self->sip_log = NULL;
+    }
+    if (self->provision) {
+        mtk_provision_free(self->provision);
+        self->provision = NULL;
+    }
+    if (self->ims_cfg) {
+        mtk_ims_cfg_free(self->ims_cfg);
+        self->ims_cfg = NULL;
+    }
+}
+
+static
+guint
+mtk_slot_call_count(
+    void* user_data)
+{
+    MtkSlot* self = THIS(user_data);
+
+    return self->ims_call ? mtk_ims_call_count(self->ims_call) : 0;
+}
+
+static
+gboolean
+mtk_slot_incoming_call_filter(
+    MtkRadioExt* radio,
+    const char* number,
+    int* cause,
+    void* user_data)
+{
+    return mtk_call_policy_allow_incoming(THIS(user_data)->call_policy,
+        number, cause);
+}
+
+static
+void
+mtk_slot_configure_dtmf(
+    BinderExtCall* ims_call,
+    GHashTable* params)
+{
+    const char* chars = params ? g_hash_table_lookup(params,
+        MTK_SLOT_DTMF_PAUSE_CHARS) : NULL;
+    const char* ms = params ? g_hash_table_lookup(params,
+        MTK_SLOT_DTMF_PAUSE_DURATION) : NULL;
+
+    mtk_ims_call_set_dtmf_pause(ims_call, chars, ms ? MAX(atoi(ms), 0) : 0);
+}
+
+static
+void
+mtk_slot_provision_done(
+    MtkProvision* provision,
+    guint sent,
+    guint failed,
+    void* user_data)
+{
+    if (failed) {
+        ofono_warn("%u of %u IMS provisioning value(s) failed", failed, sent);
+    }
+}
+
+static
+void
+mtk_slot_provision(
+    MtkSlot* self,
+    const char* slot_name,
+    GHashTable* params)
+{
+    const char* file = params ? g_hash_table_lookup(params,
+        MTK_SLOT_IMS_PROVISIONING) : NULL;
+
+    if (file) {
+        char* cache = g_strdup_printf(MTK_SLOT_PROVISION_CACHE_DIR
+            "/mtk-provision-%s", slot_name);
+
+        self->provision = mtk_provision_new(self->radio_ext, self->ims_cfg,
+            cache);
+        mtk_provision_apply(self->provision, file, mtk_slot_provision_done,
+            self);
+        g_free(cache);
+    }
 }
 
 /*==========================================================================*
@@ -136,7 +254,22 @@ mtk_slot_new(
     if (self->radio_ext) {
         self->ims = mtk_ims_new(slot_name, self->radio_ext);
         self->ims_call = mtk_ims_call_new(self->radio_ext, self->ims_aosp_client);
+        mtk_slot_configure_dtmf(self->ims_call, params);
+        self->dbus = mtk_dbus_new(slot_name);
+        mtk_dbus_set_radio_ext(self->dbus, self->radio_ext);
+        mtk_dbus_set_cdr(self->dbus, mtk_ims_call_cdr(self->ims_call));
+        mtk_dbus_set_ssac(self->dbus, mtk_ims_call_ssac(self->ims_call));
+        mtk_dbus_set_ims_call(self->dbus, self->ims_call);
+        self->sip_log = mtk_sip_log_new(self->radio_ext,
+            MTK_SLOT_SIP_LOG_SIZE);
+        mtk_dbus_set_sip_log(self->dbus, self->sip_log);
+        self->ims_cfg = mtk_ims_cfg_new(self->radio_ext);
+        mtk_slot_provision(self, slot_name, params);
         self->ims_sms = mtk_ims_sms_new(self->radio_ext, self->ims_aosp_client);
+        self->call_policy = mtk_call_policy_new(params, mtk_slot_call_count,
+            self);
+        mtk_radio_ext_set_incoming_call_filter(self->radio_ext,
+            mtk_slot_incoming_call_filter, self);
     }
 
     return slot;
@@ -0,0 +1,299 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include "mtk_ssac.h"
+
+#include <ofono/log.h>
+
+#include <string.h>
+
+typedef struct mtk_ssac_barring {
+    guint factor;
+    guint time;
+    gint64 until; /* Monotonic, zero if not barred */
+    guint barred;
+    guint held;
+} MtkSsacBarring;
+
+typedef struct mtk_ssac_wait {
+    MtkSsac* ssac;
+    MTK_SSAC_CATEGORY category;
+    guint id;
+    guint timeout_id;
+    gint64 deadline; /* Monotonic */
+    MtkSsacWaitFunc func;
+    GDestroyNotify destroy;
+    void* user_data;
+} MtkSsacWait;
+
+struct mtk_ssac {
+    MtkSsacBarring barring[MTK_SSAC_COUNT];
+    GHashTable* waits; /* id => MtkSsacWait */
+    guint last_id;
+    MtkSsacFunc change_func;
+    void* change_data;
+};
+
+#define ID_KEY(id) GUINT_TO_POINTER(id)
+
+static const char* mtk_ssac_category_name[] = { "voice", "video" };
+G_STATIC_ASSERT(G_N_ELEMENTS(mtk_ssac_category_name) == MTK_SSAC_COUNT);
+
+static
+void
+mtk_ssac_changed(
+    MtkSsac* self)
+{
+    if (self->change_func) {
+        self->change_func(self, self->change_data);
+    }
+}
+
+static
+guint
+mtk_ssac_remaining(
+    const MtkSsacBarring* barring,
+    gint64 now)
+{
+    return (barring->until > now) ?
+        (guint)((barring->until - now + 999) / 1000) : 0;
+}
+
+static
+void
+mtk_ssac_wait_free(
+    gpointer data)
+{
+    MtkSsacWait* wait = data;
+
+    if (wait->timeout_id) {
+        g_source_remove(wait->timeout_id);
+    }
+    if (wait->destroy) {
+        wait->destroy(wait->user_data);
+    }
+    g_slice_free(MtkSsacWait, wait);
+}
+
+static
+gboolean
+mtk_ssac_wait_timeout(
+    gpointer data)
+{
+    MtkSsacWait* wait = data;
+    MtkSsac* self = wait->ssac;
+    const guint ms = mtk_ssac_check(self, wait->category);
+
+    if (ms && g_get_monotonic_time() + (gint64)ms * 1000 <= wait->deadline) {
+        /* Barred again */
+        wait->timeout_id = g_timeout_add(ms, mtk_ssac_wait_timeout, wait);
+    } else {
+        if (ms) {
+            DBG("%s barred past the deadline",
+                mtk_ssac_category_name[wait->category]);
+        }
+        wait->timeout_id = 0;
+        wait->func(self, !ms, wait->user_data);
+        g_hash_table_remove(self->waits, ID_KEY(wait->id));
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+mtk_ssac_wait_now(
+    MtkSsac* self,
+    MTK_SSAC_CATEGORY category)
+{
+    GHashTableIter it;
+    gpointer value;
+
+    /* Check again right away rather than when the barring would expire */
+    g_hash_table_iter_init(&it, self->waits);
+    while (g_hash_table_iter_next(&it, NULL, &value)) {
+        MtkSsacWait* wait = value;
+
+        if (wait->category == category && wait->timeout_id) {
+            g_source_remove(wait->timeout_id);
+            wait->timeout_id = g_idle_add(mtk_ssac_wait_timeout, wait);
+        }
+    }
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+MtkSsac*
+mtk_ssac_new(
+    void)
+{
+    MtkSsac* self = g_new0(MtkSsac, 1);
+    int i;
+
+    self->waits = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+        NULL, mtk_ssac_wait_free);
+    for (i = 0; i < MTK_SSAC_COUNT; i++) {
+        self->barring[i].factor = MTK_SSAC_NO_BARRING;
+    }
+    return self;
+}
+
+void
+mtk_ssac_free(
+    MtkSsac* self)
+{
+    if (self) {
+        g_hash_table_destroy(self->waits);
+        g_free(self);
+    }
+}
+
+void
+mtk_ssac_set_change_func(
+    MtkSsac* self,
+    MtkSsacFunc func,
+    void* user_data)
+{
+    if (G_LIKELY(self)) {
+        self->change_func = func;
+        self->change_data = user_data;
+    }
+}
+
+void
+mtk_ssac_update(
+    MtkSsac* self,
+    MTK_SSAC_CATEGORY category,
+    guint factor,
+    guint time)
+{
+    if (G_LIKELY(self) && category < MTK_SSAC_COUNT) {
+        MtkSsacBarring* barring = self->barring + category;
+
+        factor = MIN(factor, MTK_SSAC_NO_BARRING);
+        if (barring->factor != factor || barring->time != time) {
+            DBG("%s barring factor %u%%, time %us",
+                mtk_ssac_category_name[category], factor, time);
+            barring->factor = factor;
+            barring->time = time;
+            if (factor == MTK_SSAC_NO_BARRING) {
+                /* Lifted, waits don't have to sit out the barring */
+                barring->until = 0;
+                mtk_ssac_wait_now(self, category);
+            }
+            mtk_ssac_changed(self);
+        }
+    }
+}
+
+guint
+mtk_ssac_check(
+    MtkSsac* self,
+    MTK_SSAC_CATEGORY category)
+{
+    if (G_LIKELY(self) && category < MTK_SSAC_COUNT) {
+        MtkSsacBarring* barring = self->barring + category;
+        const gint64 now = g_get_monotonic_time();
+        guint ms = mtk_ssac_remaining(barring, now);
+
+        if (!ms && barring->factor < MTK_SSAC_NO_BARRING &&
+            g_random_int_range(0, MTK_SSAC_NO_BARRING) >=
+            (gint32)barring->factor) {
+            /* Tbarring = (0.7 + 0.6 * rand) * ssac-BarringTime */
+            ms = (guint)((0.7 + 0.6 * g_random_double()) *
+                barring->time * 1000);
+            barring->until = now + (gint64)ms * 1000;
+            barring->barred++;
+            DBG("%s barred for %u ms, %u time(s)",
+                mtk_ssac_category_name[category], ms, barring->barred);
+            mtk_ssac_changed(self);
+        }
+        return ms;
+    }
+    return 0;
+}
+
+guint
+mtk_ssac_wait(
+    MtkSsac* self,
+    MTK_SSAC_CATEGORY category,
+    guint max_ms,
+    MtkSsacWaitFunc func,
+    GDestroyNotify destroy,
+    void* user_data)
+{
+    if (G_LIKELY(self) && category < MTK_SSAC_COUNT && G_LIKELY(func)) {
+        const guint ms = mtk_ssac_check(self, category);
+        MtkSsacWait* wait = g_slice_new0(MtkSsacWait);
+
+        do {
+            wait->id = ++(self->last_id);
+        } while (!wait->id || g_hash_table_contains(self->waits,
+            ID_KEY(wait->id)));
+        wait->ssac = self;
+        wait->category = category;
+        wait->deadline = g_get_monotonic_time() + (gint64)max_ms * 1000;
+        wait->func = func;
+        wait->destroy = destroy;
+        wait->user_data = user_data;
+        wait->timeout_id = g_timeout_add(ms, mtk_ssac_wait_timeout, wait);
+        g_hash_table_insert(self->waits, ID_KEY(wait->id), wait);
+        if (ms) {
+            self->barring[category].held++;
+        }
+        return wait->id;
+    }
+    return 0;
+}
+
+void
+mtk_ssac_cancel(
+    MtkSsac* self,
+    guint id)
+{
+    if (G_LIKELY(self) && id) {
+        g_hash_table_remove(self->waits, ID_KEY(id));
+    }
+}
+
+void
+mtk_ssac_status(
+    MtkSsac* self,
+    MTK_SSAC_CATEGORY category,
+    MtkSsacStatus* status)
+{
+    memset(status, 0, sizeof(*status));
+    if (G_LIKELY(self) && category < MTK_SSAC_COUNT) {
+        const MtkSsacBarring* barring = self->barring + category;
+
+        status->factor = barring->factor;
+        status->time = barring->time;
+        status->remaining = mtk_ssac_remaining(barring,
+            g_get_monotonic_time());
+        status->barred = barring->barred;
+        status->held = barring->held;
+    } else {
+        status->factor = MTK_SSAC_NO_BARRING;
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
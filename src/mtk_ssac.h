@@ -0,0 +1,128 @@
+/*
+ *  oFono - Open Source Telephony - binder based adaptation MTK plugin
+ *
+ *  Copyright (C) 2024 TheKit <thekit@disroot.org>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License version 2 as
+ *  published by the Free Software Foundation.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#ifndef MTK_SSAC_H
+#define MTK_SSAC_H
+
+#include <glib.h>
+
+/*
+ * Service specific access control (3GPP TS 24.173 annex J). When the
+ * cell bars MMTEL voice or video, each attempt passes with the barring
+ * factor probability, otherwise the service remains barred for a random
+ * 70-130% of the barring time. Operations can either check the barring
+ * and fail, or wait until it expires.
+ */
+
+typedef struct mtk_ssac MtkSsac;
+
+typedef enum mtk_ssac_category {
+    MTK_SSAC_VOICE,
+    MTK_SSAC_VIDEO,
+    MTK_SSAC_COUNT
+} MTK_SSAC_CATEGORY;
+
+#define MTK_SSAC_NO_BARRING (100)
+
+typedef struct mtk_ssac_status {
+    guint factor;     /* Percent, MTK_SSAC_NO_BARRING if not barred */
+    guint time;       /* Seconds */
+    guint remaining;  /* Milliseconds until the current barring expires */
+    guint barred;     /* Attempts that have been barred */
+    guint held;       /* Attempts that have waited for the barring */
+} MtkSsacStatus;
+
+typedef void (*MtkSsacFunc)(
+    MtkSsac* ssac,
+    void* user_data);
+
+/* ok is FALSE if the barring would have lasted too long */
+typedef void (*MtkSsacWaitFunc)(
+    MtkSsac* ssac,
+    gboolean ok,
+    void* user_data);
+
+MtkSsac*
+mtk_ssac_new(
+    void)
+    G_GNUC_INTERNAL;
+
+/* Pending waits are cancelled */
+void
+mtk_ssac_free(
+    MtkSsac* ssac)
+    G_GNUC_INTERNAL;
+
+/* Called when the parameters change or a barring starts */
+void
+mtk_ssac_set_change_func(
+    MtkSsac* ssac,
+    MtkSsacFunc func,
+    void* user_data)
+    G_GNUC_INTERNAL;
+
+void
+mtk_ssac_update(
+    MtkSsac* ssac,
+    MTK_SSAC_CATEGORY category,
+    guint factor,
+    guint time)
+    G_GNUC_INTERNAL;
+
+/* Makes an access attempt, returns zero or milliseconds to wait */
+guint
+mtk_ssac_check(
+    MtkSsac* ssac,
+    MTK_SSAC_CATEGORY category)
+    G_GNUC_INTERNAL;
+
+/*
+ * Invokes the function from the main loop once an access attempt
+ * succeeds, or with ok set to FALSE as soon as it's clear that it
+ * won't within max_ms. Returns the id of the wait for mtk_ssac_cancel,
+ * the destroy function is invoked when the wait is over either way.
+ */
+guint
+mtk_ssac_wait(
+    MtkSsac* ssac,
+    MTK_SSAC_CATEGORY category,
+    guint max_ms,
+    MtkSsacWaitFunc func,
+    GDestroyNotify destroy,
+    void* user_data)
+    G_GNUC_INTERNAL;
+
+void
+mtk_ssac_cancel(
+    MtkSsac* ssac,
+    guint id)
+    G_GNUC_INTERNAL;
+
+void
+mtk_ssac_status(
+    MtkSsac* ssac,
+    MTK_SSAC_CATEGORY category,
+    MtkSsacStatus* status)
+    G_GNUC_INTERNAL;
+
+#endif /* MTK_SSAC_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */